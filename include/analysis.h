@@ -0,0 +1,58 @@
+//
+// Maze analytics: degree census, solution length, diameter and corridor shape
+//
+
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <maze.h>
+#include <string>
+#include <vector>
+
+namespace course {
+    struct MazeAnalysis {
+        static constexpr std::uint64_t NONE = UINT64_MAX;
+
+        int rows = 0;
+        int cols = 0;
+        std::uint64_t cells = 0;
+        std::uint64_t open_edges = 0;
+        /// Cells by number of open sides; the outer border always counts as a wall
+        std::uint64_t dead_ends = 0;
+        std::uint64_t corridor_cells = 0;
+        std::uint64_t junctions = 0;
+        /// Cells reached from the entrance and passages that close a loop on the way
+        std::uint64_t reached = 0;
+        std::uint64_t cycles = 0;
+        /// Steps from entrance to exit, NONE if the exit cannot be reached. With loops
+        /// (cycles > 0) this and the diameter follow the walks' spanning trees, not shortest paths
+        std::uint64_t solution_length = NONE;
+        /// Longest shortest path between any two reachable cells, in steps
+        std::uint64_t diameter = 0;
+        /// Mean cells per dead-end branch off the solution: high means few, long dead ends
+        double river_factor = 0.0;
+        /// Corridors between cells that are not plain passages (dead ends, junctions),
+        /// bucket k counts lengths in [2^k, 2^(k+1))
+        std::vector<std::uint64_t> corridor_histogram;
+        /// Peak depth of the walk from the entrance
+        std::uint64_t max_depth = 0;
+        size_t state_bytes = 0;
+        double seconds = 0.0;
+
+        void print(std::ostream& out) const;
+        void print_json(std::ostream& out) const;
+    };
+
+    /// Degree census split across threads by rows, alongside two stackless depth-first walks
+    /// (from the entrance, then from the deepest cell for the diameter). They keep 4 bits per
+    /// cell (visited + parent direction) and a few counters, whatever the depth of the walk
+    MazeAnalysis analyze_maze(const Maze& maze, unsigned threads = 1);
+    /// Same analysis over a tiled file, walls paged through tile caches of cache_bytes each
+    MazeAnalysis analyze_tiled(const std::string& filename, unsigned threads = 1,
+                               size_t cache_bytes = 64 * 1024 * 1024);
+}
+
+#endif //ANALYSIS_H
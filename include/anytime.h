@@ -0,0 +1,89 @@
+//
+// Interruptible A*: bounded slices under a deadline, node budget or cancellation token
+//
+
+#ifndef ANYTIME_H
+#define ANYTIME_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <maze.h>
+#include <pathcodec.h>
+#include <searchcore.h>
+#include <utility>
+#include <vector>
+
+namespace course {
+    /// Limits on one slice of work; an unset limit does not apply
+    struct SearchBudget {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point deadline = Clock::time_point::max();
+        /// Cells to expand in this slice, 0 for no limit
+        std::uint64_t max_expansions = 0;
+        /// Polled together with the clock; set it from any thread to stop the slice
+        const std::atomic<bool>* cancel = nullptr;
+
+        static SearchBudget within(std::chrono::milliseconds ms) {
+            SearchBudget budget;
+            budget.deadline = Clock::now() + ms;
+            return budget;
+        }
+    };
+
+    struct AnytimeResult {
+        enum class Status { Found, Unreachable, OutOfBudget, Cancelled };
+
+        Status status = Status::OutOfBudget;
+        /// Full path if Found, otherwise the path to the closest cell reached so far
+        PathCodec path;
+        /// Expanded cell with the smallest Manhattan distance to the goal
+        std::pair<int, int> closest{-1, -1};
+        std::uint32_t closest_distance = 0;
+        /// No path can be shorter than this: the smallest f still open
+        std::uint32_t lower_bound = 0;
+        /// Expanded in this slice and over all slices
+        std::uint64_t expanded = 0;
+        std::uint64_t total_expanded = 0;
+
+        bool done() const { return status == Status::Found || status == Status::Unreachable; }
+    };
+
+    const char* status_name(AnytimeResult::Status status);
+
+    /// A* whose open list, g-scores and parents outlive each call, so a search cut short by
+    /// its budget continues where it stopped on the next run(). The clock and the cancel
+    /// flag are polled every CHECK_INTERVAL expansions to keep the hot loop cheap
+    class AnytimeSolver {
+    public:
+        static constexpr std::uint64_t CHECK_INTERVAL = 256;
+
+        AnytimeSolver(const Maze& maze, const std::pair<int, int>& start, const std::pair<int, int>& goal);
+
+        /// Expands cells until the goal is closed, the open list empties or the budget runs out
+        AnytimeResult run(const SearchBudget& budget);
+        bool finished() const { return finished_; }
+        std::uint64_t expanded() const { return expanded_; }
+
+    private:
+        OpenGrid grid_;
+        std::uint32_t source_;
+        std::uint32_t target_;
+        int goalRow_, goalCol_;
+        std::vector<std::uint32_t> g_;
+        std::vector<std::uint32_t> parent_;
+        std::vector<std::uint8_t> closed_;
+        /// (f << 32 | cell), smallest on top
+        std::vector<std::uint64_t> heap_;
+        std::uint32_t closest_;
+        std::uint64_t expanded_{0};
+        bool finished_{false};
+        bool found_{false};
+
+        std::uint32_t estimate(std::uint32_t cell) const;
+        PathCodec path_to(std::uint32_t cell) const;
+    };
+}
+
+#endif //ANYTIME_H
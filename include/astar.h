@@ -7,6 +7,7 @@
 
 #include <map>
 #include <maze.h>
+#include <pathcodec.h>
 #include <utility>
 
 namespace course {
@@ -35,20 +36,26 @@ namespace course {
         };
 
     public:
-        explicit Astar(Maze &maze) : maze_(std::move(maze)) {}
+        explicit Astar(const Maze &maze) : maze_(maze) {}
 
-        std::vector<std::pair<int, int>> find_path();
-        void print_path(const std::vector<std::pair<int, int>> &path);
-        void print_path_at(const std::vector<std::pair<int, int>>& path);
-        std::vector<std::pair<int, int>> get_path() { return path_; }
+        PathCodec find_path();
+        /// Shortest path between any two cells; empty if unreachable
+        PathCodec find_path(const std::pair<int, int>& start, const std::pair<int, int>& goal);
+        /// Cells closed by the last search
+        size_t get_expanded() const { return expanded_; }
+        void print_path(const PathCodec &path);
+        void print_path_at(const PathCodec& path);
+        const PathCodec& get_path() const { return path_; }
 
     private:
-        Maze maze_;
-        std::vector<std::pair<int, int>> path_;
+        const Maze& maze_;
+        PathCodec path_;
+        size_t expanded_{0};
 
+        static void print_path_stats(const PathCodec& path);
         static double heuristic(const std::pair<int, int>& dot_a, const std::pair<int, int>& dot_b) ;
         std::vector<std::pair<int, int>> get_neighbors(const std::pair<int, int>& node) const;
-        static std::vector<std::pair<int, int>> reconstruct_path(
+        static PathCodec reconstruct_path(
             const std::map<std::pair<int, int>, std::pair<int, int>>& came_from,
             const std::pair<int, int>& current);
         bool is_valid_move(int from_row, int from_col, int to_row, int to_col) const;
@@ -0,0 +1,58 @@
+//
+// Benchmark harness for maze algorithms
+//
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace course {
+    struct BenchOptions {
+        int rows = 512;
+        int cols = 512;
+        /// Thread counts are doubled from 1 up to this value
+        unsigned max_threads = 1;
+        int repeats = 3;
+        std::uint64_t seed = 42;
+        /// Generator used to build input mazes for search benchmarks
+        std::string algo = "kruskal";
+        /// Concurrent races hosted by the race server benchmark
+        int sessions = 1000;
+        /// Moves issued per thread count in the race server benchmark
+        int moves = 200000;
+        /// Cluster side used by the HPA* benchmark
+        int cluster = 16;
+        /// Random endpoint pairs per search benchmark
+        int queries = 20;
+        /// Landmarks used by the ALT benchmark
+        int landmarks = 8;
+        /// Random waypoints per route in the route benchmark
+        int waypoints = 12;
+    };
+
+    /// Thread counts used for scaling figures: 1, 2, 4, ... max_threads
+    std::vector<unsigned> bench_thread_counts(unsigned max_threads);
+
+    /// Cells per second and thread scaling for every registered generator
+    void bench_generators(const BenchOptions& options, std::ostream& out);
+    /// Scalar Eller against the word-level kernel on widening mazes, checking identical output
+    void bench_eller(const BenchOptions& options, std::ostream& out);
+    /// Whole-maze distance field from the exit, thread scaling
+    void bench_distances(const BenchOptions& options, std::ostream& out);
+    /// Random moves from concurrent clients against many in-memory races
+    void bench_race_server(const BenchOptions& options, std::ostream& out);
+    /// HPA* preprocessing scaling, then query time and expansions against flat A*
+    void bench_hpa(const BenchOptions& options, std::ostream& out);
+    /// Policy-templated solvers side by side with the classic A* on random queries
+    void bench_solvers(const BenchOptions& options, std::ostream& out);
+    /// Landmark preprocessing scaling, then expansions of ALT against Manhattan A*
+    void bench_alt(const BenchOptions& options, std::ostream& out);
+    /// Waypoint distance matrix scaling, then exact against heuristic ordering
+    void bench_route(const BenchOptions& options, std::ostream& out);
+}
+
+#endif //BENCH_H
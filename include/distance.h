@@ -0,0 +1,83 @@
+//
+// Whole-maze distance field from one or more source cells
+//
+
+#ifndef DISTANCE_H
+#define DISTANCE_H
+
+#include <cstdint>
+#include <limits>
+#include <maze.h>
+#include <pathcodec.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace course {
+    class DistanceField {
+    public:
+        static constexpr std::uint32_t UNREACHABLE = std::numeric_limits<std::uint32_t>::max();
+
+        struct Stats {
+            std::uint32_t levels = 0;
+            /// Levels wide enough to be split across threads
+            std::uint32_t parallel_levels = 0;
+            size_t peak_frontier = 0;
+            std::uint64_t reached = 0;
+        };
+
+        /// Level-synchronous BFS over open passages, wide levels split across threads
+        static DistanceField compute(const Maze& maze, const std::pair<int, int>& source, unsigned threads = 1);
+        /// Same BFS started from every source at once: each cell gets the distance to its
+        /// nearest source and, with several sources, which one (ties go to the lowest index)
+        static DistanceField compute(const Maze& maze, const std::vector<std::pair<int, int>>& sources,
+                                     unsigned threads = 1);
+
+        int getRows() const { return rows_; }
+        int getCols() const { return cols_; }
+        auto get_source() const { return source_; }
+        const std::vector<std::pair<int, int>>& sources() const { return sources_; }
+        const Stats& stats() const { return stats_; }
+        std::uint32_t max_distance() const;
+
+        std::uint32_t at(const int row, const int col) const {
+            return dist_[static_cast<size_t>(row) * cols_ + col];
+        }
+        const std::vector<std::uint32_t>& data() const { return dist_; }
+        /// Index into sources() of the cell's nearest source
+        std::uint32_t nearest(const int row, const int col) const {
+            return nearest_.empty() ? 0 : nearest_[static_cast<size_t>(row) * cols_ + col];
+        }
+        /// Shortest path from cell to its nearest source, empty if unreachable
+        PathCodec path_from(const Maze& maze, const std::pair<int, int>& cell) const;
+
+        /// Binary form: header, then each distance in the fewest bytes that fit the maximum.
+        /// maze_hash (Maze::content_hash) lets readers tell a field of another maze apart
+        void to_file(const std::string& filename, std::uint64_t maze_hash = 0) const;
+        void from_file(const std::string& filename);
+        /// Reads only the requested cells from a saved field; values are fixed width so each is one seek
+        static std::vector<std::uint32_t> read_cells(const std::string& filename,
+                                                     const std::vector<std::pair<int, int>>& cells);
+        /// Rows, cols, source and maze hash stored in a saved field, without reading the
+        /// distances; the hash is 0 in files written without one
+        static bool read_header(const std::string& filename, int& rows, int& cols, std::pair<int, int>& source,
+                                std::uint64_t& maze_hash);
+
+    private:
+        int rows_{0}, cols_{0};
+        std::pair<int, int> source_;
+        std::vector<std::pair<int, int>> sources_;
+        std::vector<std::uint32_t> dist_;
+        /// Nearest source per cell, only kept with more than one source
+        std::vector<std::uint32_t> nearest_;
+        Stats stats_;
+    };
+
+    /// Border cells at the two ends of the longest border-to-border path, by two BFS sweeps:
+    /// from a corner to its farthest border cell A, then from A to its farthest border cell B.
+    /// Exact in a perfect maze, since tree distances put the farthest cell of any set at an
+    /// end of that set's diameter. Only cells reachable from (0, 0) are considered
+    std::pair<std::pair<int, int>, std::pair<int, int>> farthest_border_pair(const Maze& maze, unsigned threads = 1);
+}
+
+#endif //DISTANCE_H
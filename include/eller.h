@@ -0,0 +1,57 @@
+//
+// Eller's algorithm on 64-bit words: seeded row decisions and the bit-parallel row kernel
+//
+
+#ifndef ELLER_H
+#define ELLER_H
+
+#include <cstdint>
+#include <rowstream.h>
+#include <vector>
+
+namespace course {
+    /// Random decisions of one Eller row, drawn as whole words from (seed, row):
+    /// bit c of right proposes a wall right of column c, bit c of down a wall below it
+    struct EllerRowBits {
+        std::vector<std::uint64_t> right;
+        std::vector<std::uint64_t> down;
+
+        void draw(std::uint64_t seed, int row, int cols);
+        bool right_bit(const int col) const { return right[col >> 6] >> (col & 63) & 1; }
+        bool down_bit(const int col) const { return down[col >> 6] >> (col & 63) & 1; }
+    };
+
+    /// Row kernel producing exactly the walls of the scalar Maze::generate_rows for the
+    /// same seed. Walls are proposed 64 at a time, only proposed passages reach the
+    /// union-find, and the entrance/exit exceptions are precomputed masks. Memory is O(cols)
+    class EllerKernel {
+    public:
+        EllerKernel(const MazeShape& shape, std::uint64_t seed);
+
+        /// Computes the next row, top to bottom, with the entrance and exit opened
+        void next_row(bool* vWalls, bool* hWalls);
+
+    private:
+        MazeShape shape_;
+        std::uint64_t seed_;
+        int row_{0};
+        int words_;
+        EllerRowBits bits_;
+        /// Set of each column, 0 for a cell that starts a new set
+        std::vector<std::uint32_t> set_;
+        std::vector<std::uint32_t> parent_;
+        /// Cells per root in the current row, then scratch for relabelling
+        std::vector<std::uint32_t> count_;
+        std::vector<std::uint64_t> right_, down_;
+
+        std::uint32_t find(std::uint32_t x);
+        void start_row();
+        void add_right_walls(int row);
+        void add_bottom_walls(int row);
+        void close_last_row();
+        void carry_sets();
+        void emit(int row, bool* vWalls, bool* hWalls) const;
+    };
+}
+
+#endif //ELLER_H
@@ -0,0 +1,120 @@
+//
+// Pluggable maze generators sharing the Maze wall representation
+//
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <maze.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace course {
+    /// Produces a perfect maze into vWalls/hWalls of an already sized Maze
+    class Generator {
+    public:
+        virtual ~Generator() = default;
+
+        virtual std::string name() const = 0;
+        /// True if the algorithm splits its work across threads
+        virtual bool parallel() const { return false; }
+        virtual void generate(Maze& maze, std::uint64_t seed, unsigned threads) const = 0;
+        /// Rows of a new maze in order. By default the whole maze is generated into `maze`
+        /// before the first row is yielded; Eller yields each row as soon as it is final
+        virtual RowStream generate_rows(Maze& maze, std::uint64_t seed, unsigned threads) const;
+
+        /// True if each row depends only on (seed, row), so rows can be streamed
+        virtual bool row_independent() const { return false; }
+        /// Writes one row of right and bottom walls; only valid if row_independent()
+        virtual void generate_row(int row, int rows, int cols, std::uint64_t seed,
+                                  bool* vWalls, bool* hWalls) const;
+        /// True if stream_rows can produce the maze without a Maze in memory
+        virtual bool streams_rows() const { return row_independent(); }
+        /// Rows built one at a time in O(cols) memory, default corners opened;
+        /// only valid if streams_rows()
+        virtual RowStream stream_rows(int rows, int cols, std::uint64_t seed) const;
+    };
+
+    class GeneratorRegistry {
+    public:
+        using Factory = std::function<std::unique_ptr<Generator>()>;
+
+        static GeneratorRegistry& instance();
+
+        void add(const std::string& name, Factory factory);
+        std::unique_ptr<Generator> create(const std::string& name) const;
+        std::vector<std::string> names() const;
+
+    private:
+        GeneratorRegistry();
+
+        std::map<std::string, Factory> factories_;
+    };
+
+    /// Eller's algorithm, row by row with the word-level EllerKernel in O(cols) state
+    class EllerGenerator final : public Generator {
+    public:
+        std::string name() const override { return "eller"; }
+        void generate(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+        RowStream generate_rows(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+        bool streams_rows() const override { return true; }
+        RowStream stream_rows(int rows, int cols, std::uint64_t seed) const override;
+    };
+
+    /// The same mazes as "eller" for the same seed, one cell at a time (Maze::generate_rows)
+    class EllerScalarGenerator final : public Generator {
+    public:
+        std::string name() const override { return "eller_scalar"; }
+        void generate(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+        RowStream generate_rows(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+    };
+
+    /// Every cell carves either down or right, rows are independent
+    class BinaryTreeGenerator final : public Generator {
+    public:
+        std::string name() const override { return "binary_tree"; }
+        bool parallel() const override { return true; }
+        void generate(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+        bool row_independent() const override { return true; }
+        void generate_row(int row, int rows, int cols, std::uint64_t seed,
+                          bool* vWalls, bool* hWalls) const override;
+    };
+
+    /// Horizontal runs closed by one passage down, rows are independent
+    class SidewinderGenerator final : public Generator {
+    public:
+        std::string name() const override { return "sidewinder"; }
+        bool parallel() const override { return true; }
+        void generate(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+        bool row_independent() const override { return true; }
+        void generate_row(int row, int rows, int cols, std::uint64_t seed,
+                          bool* vWalls, bool* hWalls) const override;
+    };
+
+    /// Loop-erased random walks, uniform spanning tree
+    class WilsonGenerator final : public Generator {
+    public:
+        std::string name() const override { return "wilson"; }
+        void generate(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+    };
+
+    /// Randomized Kruskal over a shuffled edge list with union-find
+    class KruskalGenerator final : public Generator {
+    public:
+        std::string name() const override { return "kruskal"; }
+        void generate(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+    };
+
+    /// Depth-first backtracker with an explicit stack
+    class BacktrackerGenerator final : public Generator {
+    public:
+        std::string name() const override { return "backtracker"; }
+        void generate(Maze& maze, std::uint64_t seed, unsigned threads) const override;
+    };
+}
+
+#endif //GENERATOR_H
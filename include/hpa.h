@@ -0,0 +1,83 @@
+//
+// Hierarchical pathfinding (HPA*): cluster abstraction with exact intra-cluster distances
+//
+
+#ifndef HPA_H
+#define HPA_H
+
+#include <cstdint>
+#include <maze.h>
+#include <pathcodec.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace course {
+    /// Every open passage between two clusters becomes a pair of abstract nodes, so
+    /// abstract paths are exact and refined paths are shortest paths
+    class HpaGraph {
+    public:
+        struct BuildStats {
+            size_t clusters = 0;
+            size_t nodes = 0;
+            size_t edges = 0;
+            double seconds = 0.0;
+        };
+
+        struct QueryStats {
+            /// Abstract nodes closed by the graph search
+            size_t abstract_expanded = 0;
+            /// Cells visited while connecting endpoints and refining
+            size_t cells_expanded = 0;
+        };
+
+        /// The maze must stay unchanged while the graph is used
+        HpaGraph(const Maze& maze, int cluster_size = 16, unsigned threads = 1);
+
+        /// Safe to call from several threads at once
+        PathCodec find_path(const std::pair<int, int>& start, const std::pair<int, int>& goal,
+                            QueryStats* stats = nullptr) const;
+        PathCodec find_path(QueryStats* stats = nullptr) const {
+            return find_path(maze_.get_entrance(), maze_.get_exit(), stats);
+        }
+
+        int cluster_size() const { return size_; }
+        const BuildStats& build_stats() const { return buildStats_; }
+
+    private:
+        struct Edge {
+            int to;
+            std::uint32_t cost;
+        };
+
+        struct Cluster {
+            int row0, col0, rows, cols;
+            std::vector<int> nodes;
+        };
+
+        const Maze& maze_;
+        int size_;
+        int clustersX_{0}, clustersY_{0};
+        std::vector<Cluster> clusters_;
+        std::vector<std::pair<int, int>> nodeCells_;
+        std::vector<std::vector<Edge>> edges_;
+        std::unordered_map<std::int64_t, int> nodeOf_;
+        BuildStats buildStats_;
+
+        int cluster_of(const std::pair<int, int>& cell) const {
+            return cell.first / size_ * clustersX_ + cell.second / size_;
+        }
+        std::int64_t key(const std::pair<int, int>& cell) const {
+            return static_cast<std::int64_t>(cell.first) * maze_.getCols() + cell.second;
+        }
+        int add_node(const std::pair<int, int>& cell);
+        /// BFS confined to one cluster; dist and parent are indexed by cluster-local cell.
+        /// Returns the number of cells visited
+        size_t cluster_bfs(const Cluster& cluster, const std::pair<int, int>& source,
+                           std::vector<std::uint32_t>& dist, std::vector<int>* parent) const;
+        size_t refine(const Cluster& cluster, const std::pair<int, int>& from,
+                      const std::pair<int, int>& to, PathCodec& path) const;
+    };
+}
+
+#endif //HPA_H
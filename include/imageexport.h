@@ -0,0 +1,25 @@
+//
+// Streaming PBM/PGM export: walls as black pixels, one band of rows in memory
+//
+
+#ifndef IMAGEEXPORT_H
+#define IMAGEEXPORT_H
+
+#include <maze.h>
+#include <pathcodec.h>
+#include <string>
+
+namespace course {
+    class TiledMazeReader;
+
+    /// Every cell and every wall is a scale x scale square, so the image is
+    /// (2 * cols + 1) * scale pixels wide. Without a path the output is a 1-bit PBM (P4);
+    /// with one it is an 8-bit PGM (P5) with the path drawn in grey
+    void export_image(const Maze& maze, const std::string& filename, int scale = 1,
+                      const PathCodec* path = nullptr);
+    /// Reads one row of tiles at a time, so memory does not grow with the maze height
+    void export_image(TiledMazeReader& reader, const std::string& filename, int scale = 1,
+                      const PathCodec* path = nullptr);
+}
+
+#endif //IMAGEEXPORT_H
@@ -0,0 +1,66 @@
+//
+// Landmark distance tables for ALT (A*, landmarks, triangle inequality) heuristics
+//
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <cstdint>
+#include <maze.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace course {
+    /// Exact BFS distances from k landmark cells, stored cell-major so one estimate
+    /// reads k neighbouring values; 16-bit entries when every distance fits
+    class Landmarks {
+    public:
+        enum class Selection {
+            /// Each landmark is the cell farthest from those already chosen
+            Farthest,
+            /// Evenly spaced along the border; all BFS runs are independent
+            Perimeter
+        };
+
+        struct Stats {
+            double seconds = 0.0;
+            size_t bytes = 0;
+            bool narrow = false;
+        };
+
+        static constexpr std::uint32_t UNREACHABLE = 0xFFFFFFFF;
+
+        Landmarks(const Maze& maze, int count, unsigned threads = 1, Selection selection = Selection::Farthest);
+
+        static Selection parse_selection(const std::string& name);
+
+        int count() const { return count_; }
+        int cols() const { return cols_; }
+        const std::vector<std::pair<int, int>>& cells() const { return cells_; }
+        const Stats& stats() const { return stats_; }
+
+        std::uint32_t distance(const std::uint32_t cell, const int landmark) const {
+            const size_t i = static_cast<size_t>(cell) * count_ + landmark;
+            if (!narrow_.empty()) return narrow_[i] == NARROW_UNREACHABLE ? UNREACHABLE : narrow_[i];
+            return wide_[i];
+        }
+
+        /// Copies the k distances of a cell into out
+        void load(std::uint32_t cell, std::uint32_t* out) const;
+        /// max over landmarks of |d(L, a) - d(L, b)|, a lower bound on d(a, b)
+        std::uint32_t lower_bound(const std::uint32_t* goal, std::uint32_t cell) const;
+
+    private:
+        static constexpr std::uint16_t NARROW_UNREACHABLE = 0xFFFF;
+
+        int count_;
+        int cols_;
+        std::vector<std::pair<int, int>> cells_;
+        std::vector<std::uint16_t> narrow_;
+        std::vector<std::uint32_t> wide_;
+        Stats stats_;
+    };
+}
+
+#endif //LANDMARKS_H
@@ -0,0 +1,75 @@
+//
+// Synthetic players driving race mode, with throughput and latency figures
+//
+
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <maze.h>
+#include <string>
+
+namespace course {
+    /// Log-linear histogram of nanosecond latencies, 8 sub-buckets per power of two
+    class LatencyHistogram {
+    public:
+        void add(std::uint64_t ns);
+        void merge(const LatencyHistogram& other);
+
+        std::uint64_t count() const { return count_; }
+        std::uint64_t max() const { return max_; }
+        double mean() const { return count_ ? static_cast<double>(total_) / count_ : 0.0; }
+        /// Upper bound of the bucket holding the p-th fraction of samples
+        std::uint64_t percentile(double p) const;
+        /// One line per non-empty power of two with a proportional bar
+        void print(std::ostream& out) const;
+
+    private:
+        static constexpr int SUB_BUCKETS = 8;
+        static constexpr int BUCKETS = 64 * SUB_BUCKETS;
+
+        std::array<std::uint64_t, BUCKETS> buckets_{};
+        std::uint64_t count_{0};
+        std::uint64_t total_{0};
+        std::uint64_t max_{0};
+
+        static int bucket_of(std::uint64_t ns);
+        static std::uint64_t upper_bound(int bucket);
+    };
+
+    struct LoadgenOptions {
+        enum class Strategy { Random, WallFollower, Optimal };
+        enum class Mode { Memory, Persistent };
+
+        int players = 100;
+        /// Moves issued by each player; finished players start a new race
+        int moves = 1000;
+        unsigned threads = 1;
+        Strategy strategy = Strategy::Random;
+        /// Optimal strategy only: chance of a random move instead of the hint
+        double noise = 0.1;
+        /// Memory drives a RaceServer; Persistent reloads and saves race files on every
+        /// move like the CLI does, one player at a time in a scratch directory
+        Mode mode = Mode::Memory;
+        std::uint64_t seed = 42;
+
+        static Strategy parse_strategy(const std::string& name);
+        static Mode parse_mode(const std::string& name);
+    };
+
+    struct LoadgenReport {
+        std::uint64_t moves = 0;
+        std::uint64_t blocked = 0;
+        std::uint64_t finished = 0;
+        double seconds = 0.0;
+        LatencyHistogram latency;
+
+        void print(const LoadgenOptions& options, std::ostream& out) const;
+    };
+
+    LoadgenReport run_loadgen(const Maze& maze, const LoadgenOptions& options);
+}
+
+#endif //LOADGEN_H
@@ -21,6 +21,9 @@ namespace course {
 
         Matrix operator=(const Matrix& rhs);
         bool& operator()(int row, int col);
+        bool operator()(int row, int col) const;
+        /// Contiguous cells of one row
+        const bool* row(int row) const { return matrix_[row]; }
 
     private:
         inline void allocate(int rows, int cols);
@@ -7,9 +7,13 @@
 
 #define EMPTY 0
 
+#include <cstdint>
+#include <eller.h>
 #include <fstream>
 #include <iosfwd>
 #include <matrix.h>
+#include <rowstream.h>
+#include <string>
 #include <vector>
 
 namespace course {
@@ -22,28 +26,55 @@ namespace course {
         int counter_{0};
         std::pair<int, int> entrance_;
         std::pair<int, int> exit_;
+        std::vector<std::pair<int, int>> extraExits_;
+        EllerRowBits rowBits_;
 
     public:
+        /// Largest side accepted by generation and loading; keeps cell indices within 32 bits
+        static constexpr int MAX_SIDE = 65535;
+        /// Widest maze that print_maze and the path printers draw as ASCII
+        static constexpr int PRINT_MAX_COLS = 60;
+
         int getRows() const { return rows_; }
         int getCols() const { return cols_; }
         Matrix& get_h_walls() {return hWalls_;}
         Matrix& get_v_walls() {return vWalls_;}
-        Matrix get_h_walls() const  {return hWalls_;}
-        Matrix get_v_walls() const {return vWalls_;}
+        const Matrix& get_h_walls() const {return hWalls_;}
+        const Matrix& get_v_walls() const {return vWalls_;}
         auto get_entrance() const { return entrance_; }
         auto get_exit() const { return exit_; }
+        /// Every exit, get_exit() first
+        std::vector<std::pair<int, int>> get_exits() const;
+        bool is_exit(int row, int col) const;
 
         void set_entrance(int row, int col);
         void set_exit(int row, int col);
+        /// Adds another exit and opens its border wall; false if outside or already an exit
+        bool add_exit(int row, int col);
+        /// Drops all exits but the first, closing their openings
+        void clear_extra_exits();
         void set_sizes(int rows, int cols);
         void from_file(const std::string& filename);
-        static bool get_random_bool();
+        /// Eller's algorithm with a random seed
         void generate_maze();
+        /// Eller's algorithm as a lazy producer: each row is yielded as soon as it is final,
+        /// with the entrance and exit already opened. This is the scalar reference for EllerKernel
+        RowStream generate_rows(std::uint64_t seed);
+        /// Replays the stored walls row by row
+        RowStream rows() const;
+        MazeShape shape() const { return {rows_, cols_, entrance_, exit_, extraExits_}; }
         void print_maze();
         void clear_gen();
         void to_file(const std::string& filename);
+        void open_entrance_exit();
+        /// Moves the endpoints after generation: the stored bottom and right borders are
+        /// closed again, then opened at the new entrance and exit
+        void move_entrance_exit(std::pair<int, int> entrance, std::pair<int, int> exit);
+        /// 64-bit hash of the size, both wall planes, entrance and exits
+        std::uint64_t content_hash() const;
 
     private:
+        void parse_endpoints();
         void fill_empty_value();
         void assign_unique_set();
         void add_vertical_walls(int row);
@@ -55,12 +86,19 @@ namespace course {
         void prepare_new_line(int row);
         void add_end_line();
         void check_end_line();
-        void open_entrance_exit();
+        void open_entrance_exit(int row);
+        void open_endpoint(int row, int col);
+        void close_border();
 
         inline void allocate_walls();
         void parse_size();
         void parse_walls(Matrix& walls);
     };
+
+    /// Lines after the walls in the text format naming the entrance and exits, e.g.
+    /// "entrance 0 4", then one "exit r c" line per exit; empty when there are only the
+    /// default corners, so older files still load
+    std::string endpoint_lines(const MazeShape& shape);
 }
 
 #endif //MAZE_H
@@ -0,0 +1,92 @@
+//
+// Compact path storage: start cell plus 2-bit moves, decoded lazily
+//
+
+#ifndef PATHCODEC_H
+#define PATHCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace course {
+    class PathCodec {
+    public:
+        enum Move : std::uint8_t { Up = 0, Down = 1, Left = 2, Right = 3 };
+
+        /// Forward iterator that applies one move per step
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::pair<int, int>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+            const_iterator() = default;
+            const_iterator(const PathCodec* codec, const size_t index, const value_type cell)
+                : codec_(codec), index_(index), cell_(cell) {}
+
+            reference operator*() const { return cell_; }
+            pointer operator->() const { return &cell_; }
+            const_iterator& operator++();
+            const_iterator operator++(int) {
+                const_iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+            bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+
+        private:
+            const PathCodec* codec_{nullptr};
+            size_t index_{0};
+            value_type cell_{-1, -1};
+        };
+
+        PathCodec() = default;
+        /// Consecutive cells must be 4-neighbours
+        explicit PathCodec(const std::vector<std::pair<int, int>>& cells);
+
+        void push_back(const std::pair<int, int>& cell);
+        void push_move(Move move);
+        void clear();
+
+        bool empty() const { return count_ == 0; }
+        /// Number of cells, i.e. moves + 1
+        size_t size() const { return count_; }
+        std::pair<int, int> front() const { return start_; }
+        std::pair<int, int> back() const { return end_; }
+        Move move_at(const size_t i) const {
+            return static_cast<Move>(moves_[i >> 5] >> ((i & 31) * 2) & 3);
+        }
+
+        const_iterator begin() const { return {this, 0, start_}; }
+        const_iterator end() const { return {this, count_, end_}; }
+        std::vector<std::pair<int, int>> decode() const;
+        size_t memory_bytes() const { return sizeof(*this) + moves_.capacity() * sizeof(std::uint64_t); }
+
+        /// Straight segments as (move, length) pairs
+        std::vector<std::pair<Move, std::uint32_t>> runs() const;
+
+        /// One text line: cell count, start, then packed moves or runs in base64,
+        /// whichever is shorter
+        void write(std::ostream& out) const;
+        void read(std::istream& in);
+
+        bool operator==(const PathCodec& other) const;
+
+        static std::pair<int, int> apply(const std::pair<int, int>& cell, Move move);
+
+    private:
+        std::pair<int, int> start_{-1, -1};
+        std::pair<int, int> end_{-1, -1};
+        size_t count_{0};
+        std::vector<std::uint64_t> moves_;
+    };
+}
+
+#endif //PATHCODEC_H
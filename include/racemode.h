@@ -7,12 +7,18 @@
 
 #include "maze.h"
 #include "astar.h"
+#include "pathcodec.h"
 #include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
 #include <vector>
 #include <utility>
 #include <string>
 
 namespace course {
+    class DistanceField;
 
     class RaceMode {
     public:
@@ -20,22 +26,52 @@ namespace course {
             int moves = 0;
             double time_seconds = 0.0;
             bool completed = false;
-            std::vector<std::pair<int, int>> path;
+            PathCodec path;
         };
 
         struct AStarStats {
             int moves = 0;
             double time_seconds = 0.0;
             bool completed = false;
-            std::vector<std::pair<int, int>> path;
+            PathCodec path;
         };
 
-        explicit RaceMode(Maze& maze);
+        struct Hint {
+            bool available = false;
+            std::string direction;
+            std::pair<int, int> next;
+            /// Steps left to the exit along the optimal path
+            std::uint32_t remaining = 0;
+        };
+
+        struct Options {
+            /// Keep the race in race_*.tmp files so it survives between CLI calls
+            bool persistent = true;
+            /// Destination of messages and frames; nullptr runs silently
+            std::ostream* out = &std::cout;
+            /// Optimal path shared by races on the same maze; solved per race if not set
+            std::shared_future<AStarStats> optimal;
+            /// Distance-to-exit field shared in memory; if not set, race_hints.tmp is used, or a
+            /// field computed on the first hint for a race that is not persistent
+            std::shared_ptr<const DistanceField> hints;
+            /// Window of cells drawn around the player; 0 draws the whole dimension
+            int viewport_rows = 0;
+            int viewport_cols = 0;
+            /// Downsampled overview of the whole maze under the viewport
+            bool minimap = false;
+        };
+
+        explicit RaceMode(const Maze& maze);
+        RaceMode(const Maze& maze, Options options);
+        ~RaceMode();
 
         // Race control
         void start_race();
         void reset_race();
+        bool is_race_started() const { return race_started_; }
         bool is_race_finished() const { return race_finished_; }
+        std::pair<int, int> get_position() const { return current_position_; }
+        const PlayerStats& get_player_stats() const { return player_stats_; }
 
         // Movement
         bool move_up();
@@ -43,15 +79,30 @@ namespace course {
         bool move_left();
         bool move_right();
 
+        // Hints from the precomputed distance-to-exit field
+        Hint get_hint();
+        void print_hint();
+
         // Display
         void print_current_state() const;
+        /// Viewport and minimap as plain ASCII lines, without legend or stats
+        std::string render_frame() const;
+        /// Redirects messages, e.g. to print results after a silent interactive race
+        void set_output(std::ostream* out) { options_.out = out; }
+        double get_elapsed_time() const;
         void print_comparison() const;
 
         // Results
         void save_results_to_file(const std::string& filename) const;
 
+        /// Optimal path with the median A* time of several runs
+        static AStarStats solve_optimal(const Maze& maze);
+
     private:
-        Maze& maze_;
+        const Maze& maze_;
+        Options options_;
+        /// Sink of a silent race; per race because manipulators change stream state
+        mutable std::ostream null_out_{nullptr};
         std::pair<int, int> current_position_;
         bool race_started_ = false;
         bool race_finished_ = false;
@@ -61,16 +112,25 @@ namespace course {
 
         std::chrono::steady_clock::time_point start_time_;
 
+        // Optimal path solved in the background while the player races
+        std::shared_future<AStarStats> astar_task_;
+
         // State persistence
         void save_state() const;
         void load_state();
+        void prepare_hints() const;
+        bool hints_match_maze() const;
 
         // Helper methods
+        std::ostream& out() const;
+        void append_minimap(std::string& frame, int row0, int col0, int rows, int cols) const;
         bool is_valid_move(int from_row, int from_col, int to_row, int to_col) const;
         bool try_move(int new_row, int new_col, const std::string& direction);
         void check_if_finished();
         void run_astar();
-        double get_elapsed_time() const;
+        void collect_astar();
+        bool load_cached_optimal();
+        void store_cached_optimal() const;
         std::string format_percentage(double value, double reference) const;
     };
 
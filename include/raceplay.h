@@ -0,0 +1,59 @@
+//
+// Interactive race: raw keyboard input and incremental ANSI redraw
+//
+
+#ifndef RACEPLAY_H
+#define RACEPLAY_H
+
+#include <racemode.h>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace course {
+    /// Screen contents as lines of ASCII; present() sends only what changed since the last call
+    class FrameBuffer {
+    public:
+        /// Replaces the pending frame, one line per '\n'
+        void assign(const std::string& text);
+        /// Writes cursor moves plus the changed runs of each line; returns the bytes written
+        size_t present(std::ostream& out);
+        /// Forces a full repaint on the next present()
+        void invalidate() { full_ = true; }
+
+    private:
+        std::vector<std::string> shown_;
+        std::vector<std::string> next_;
+        bool full_ = true;
+    };
+
+    /// Puts the terminal into unbuffered, no-echo mode on the alternate screen and
+    /// restores it on destruction
+    class RawTerminal {
+    public:
+        enum class Key { None, Up, Down, Left, Right, Hint, Redraw, Quit };
+
+        RawTerminal();
+        ~RawTerminal();
+        RawTerminal(const RawTerminal&) = delete;
+        RawTerminal& operator=(const RawTerminal&) = delete;
+
+        /// Blocks for one key: arrows, WASD or hjkl, '?' for a hint, 'r' to repaint, 'q' to quit
+        Key read_key();
+
+        /// Rows and columns of the terminal, 24x80 if unknown
+        static std::pair<int, int> size();
+
+    private:
+        struct State;
+        std::unique_ptr<State> state_;
+    };
+
+    /// Runs a started race from the keyboard until the exit is reached or the player quits.
+    /// The race must be silent; returns true if it was finished
+    bool play_race(RaceMode& race, std::ostream& out);
+}
+
+#endif //RACEPLAY_H
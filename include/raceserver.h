@@ -0,0 +1,74 @@
+//
+// In-memory race sessions over one shared, read-only maze
+//
+
+#ifndef RACESERVER_H
+#define RACESERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <maze.h>
+#include <memory>
+#include <mutex>
+#include <racemode.h>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace course {
+    class DistanceField;
+
+    /// Hosts many independent races; sessions in different shards never share a lock
+    class RaceServer {
+    public:
+        using SessionId = std::uint64_t;
+
+        enum class Direction { Up, Down, Left, Right };
+        enum class MoveResult { Moved, Blocked, Finished, NoSession, Inactive };
+
+        /// The maze must outlive the server and stay unchanged while it runs
+        explicit RaceServer(const Maze& maze, unsigned shards = 64);
+
+        RaceServer(const RaceServer&) = delete;
+        RaceServer& operator=(const RaceServer&) = delete;
+
+        /// Creates and starts a race; the id is never reused
+        SessionId create_session();
+        bool close_session(SessionId id);
+
+        MoveResult move(SessionId id, Direction direction);
+        /// Hint for the session's current cell; unavailable if the session is gone
+        RaceMode::Hint hint(SessionId id);
+        /// Position and stats of one session, copied under its lock
+        bool snapshot(SessionId id, std::pair<int, int>& position, RaceMode::PlayerStats& stats);
+
+        size_t session_count() const;
+        const RaceMode::AStarStats& optimal() const { return optimal_.get(); }
+
+    private:
+        struct Session {
+            explicit Session(const Maze& maze, const RaceMode::Options& options) : race(maze, options) {}
+
+            std::mutex mutex;
+            RaceMode race;
+        };
+
+        struct alignas(64) Shard {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<SessionId, std::shared_ptr<Session>> sessions;
+        };
+
+        const Maze& maze_;
+        // Solved and computed once, shared by every session
+        std::shared_future<RaceMode::AStarStats> optimal_;
+        std::shared_ptr<const DistanceField> hints_;
+        std::vector<Shard> shards_;
+        std::atomic<SessionId> nextId_{1};
+
+        Shard& shard_of(SessionId id) { return shards_[id % shards_.size()]; }
+        std::shared_ptr<Session> find(SessionId id);
+    };
+}
+
+#endif //RACESERVER_H
@@ -0,0 +1,49 @@
+//
+// Checkpoint routes: entrance, every waypoint in the best order found, then the exit
+//
+
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include <cstdint>
+#include <maze.h>
+#include <pathcodec.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace course {
+    struct RouteResult {
+        static constexpr std::uint32_t UNREACHABLE = 0xFFFFFFFF;
+
+        /// Entrance, waypoints in visiting order, exit
+        std::vector<std::pair<int, int>> stops;
+        /// Indices into the given waypoints, in visiting order
+        std::vector<size_t> order;
+        std::uint64_t length = 0;
+        /// True if the order came from the exact DP rather than the heuristic
+        bool exact = false;
+        PathCodec path;
+        double matrix_seconds = 0.0;
+        double order_seconds = 0.0;
+    };
+
+    /// Waypoints at most this many are ordered exactly (Held-Karp, O(2^k k^2))
+    constexpr size_t EXACT_ROUTE_WAYPOINTS = 14;
+
+    /// One "row col" per line; blank lines and lines starting with '#' are skipped
+    std::vector<std::pair<int, int>> read_waypoints(const std::string& filename);
+
+    /// Row-major n x n BFS distances between points, UNREACHABLE where there is no path.
+    /// Rows are handed out to threads that share one table of open sides and each reuse a
+    /// single set of search buffers; a search stops once it has reached every point
+    std::vector<std::uint32_t> distance_matrix(const Maze& maze, const std::vector<std::pair<int, int>>& points,
+                                               unsigned threads = 1);
+
+    /// Orders the waypoints between entrance and exit: exactly up to EXACT_ROUTE_WAYPOINTS,
+    /// otherwise nearest neighbour improved by 2-opt. Legs are then solved with A* and
+    /// stitched into one path. Throws if some stop cannot be reached
+    RouteResult plan_route(const Maze& maze, const std::vector<std::pair<int, int>>& waypoints, unsigned threads = 1);
+}
+
+#endif //ROUTE_H
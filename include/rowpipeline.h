@@ -0,0 +1,155 @@
+//
+// Single-pass row pipeline: one producer feeds many sinks, optionally on another thread
+//
+
+#ifndef ROWPIPELINE_H
+#define ROWPIPELINE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <rowstream.h>
+#include <string>
+#include <thread>
+#include <validator.h>
+#include <vector>
+
+namespace course {
+    class TiledMazeWriter;
+
+    /// Consumer of rows in top-to-bottom order
+    class RowSink {
+    public:
+        virtual ~RowSink() = default;
+
+        virtual void begin(const MazeShape&) {}
+        virtual void consume(const WallRow& row) = 0;
+        virtual void finish() {}
+    };
+
+    /// Text maze file, byte-identical to Maze::to_file. Bottom walls follow the right walls
+    /// in this format, so their lines are held until finish()
+    class TextFileSink final : public RowSink {
+    public:
+        explicit TextFileSink(std::string filename) : filename_(std::move(filename)) {}
+
+        void begin(const MazeShape& shape) override;
+        void consume(const WallRow& row) override;
+        void finish() override;
+
+    private:
+        std::string filename_;
+        std::ofstream file_;
+        MazeShape shape_;
+        std::string bottom_;
+    };
+
+    /// Tiled binary format through TiledMazeWriter, one band of tiles in memory
+    class TiledFileSink final : public RowSink {
+    public:
+        TiledFileSink(std::string filename, int tile_size = 256);
+        ~TiledFileSink() override;
+
+        void begin(const MazeShape& shape) override;
+        void consume(const WallRow& row) override;
+        void finish() override;
+
+    private:
+        std::string filename_;
+        int tile_;
+        std::unique_ptr<TiledMazeWriter> writer_;
+    };
+
+    /// Maze::content_hash of the streamed maze. The hash covers all right walls before any
+    /// bottom wall, so bottom walls are kept packed, one bit per cell
+    class HashSink final : public RowSink {
+    public:
+        void begin(const MazeShape& shape) override;
+        void consume(const WallRow& row) override;
+        void finish() override;
+        std::uint64_t value() const { return hash_; }
+
+    private:
+        MazeShape shape_;
+        std::uint64_t hash_{0};
+        std::uint64_t word_{0};
+        int bits_{0};
+        std::vector<std::uint64_t> bottom_;
+        std::uint64_t bottomBits_{0};
+
+        void mix(std::uint64_t word);
+    };
+
+    /// Cell degrees, counted with the previous row's bottom walls only
+    class StatsSink final : public RowSink {
+    public:
+        struct Stats {
+            std::uint64_t cells = 0;
+            std::uint64_t open_edges = 0;
+            std::uint64_t dead_ends = 0;
+            std::uint64_t corridors = 0;
+            std::uint64_t junctions = 0;
+        };
+
+        void begin(const MazeShape& shape) override;
+        void consume(const WallRow& row) override;
+        const Stats& stats() const { return stats_; }
+
+    private:
+        MazeShape shape_;
+        Stats stats_;
+        std::vector<std::uint8_t> openAbove_;
+    };
+
+    class ValidatorSink final : public RowSink {
+    public:
+        void begin(const MazeShape& shape) override { validator_ = std::make_unique<RowValidator>(shape); }
+        void consume(const WallRow& row) override { validator_->push_row(row.vWalls, row.hWalls); }
+        void finish() override { report_ = validator_->finish(); }
+        const ValidationReport& report() const { return report_; }
+
+    private:
+        std::unique_ptr<RowValidator> validator_;
+        ValidationReport report_;
+    };
+
+    /// Copies rows into a bounded ring buffer and feeds the downstream sinks from a worker
+    /// thread, so slow consumers (compression, disk) overlap with generation
+    class AsyncRowSink final : public RowSink {
+    public:
+        explicit AsyncRowSink(std::vector<RowSink*> downstream, size_t capacity = 64);
+        ~AsyncRowSink() override;
+
+        void begin(const MazeShape& shape) override;
+        void consume(const WallRow& row) override;
+        /// Drains the buffer, joins the worker and rethrows anything a sink threw
+        void finish() override;
+
+    private:
+        struct Slot {
+            int index = 0;
+            std::unique_ptr<bool[]> walls;
+        };
+
+        std::vector<RowSink*> downstream_;
+        std::vector<Slot> slots_;
+        int cols_{0};
+        size_t head_{0}, tail_{0};
+        bool closed_{false};
+        std::exception_ptr error_;
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        std::thread worker_;
+
+        void run();
+        void stop();
+    };
+
+    /// Pulls every row from the producer through all sinks in one pass
+    void run_pipeline(RowStream rows, const MazeShape& shape, const std::vector<RowSink*>& sinks);
+}
+
+#endif //ROWPIPELINE_H
@@ -0,0 +1,83 @@
+//
+// Lazy row producer: a coroutine that yields each finished row of walls
+//
+
+#ifndef ROWSTREAM_H
+#define ROWSTREAM_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace course {
+    /// Size and endpoints, known before the first row is produced
+    struct MazeShape {
+        int rows = 0;
+        int cols = 0;
+        std::pair<int, int> entrance{0, 0};
+        std::pair<int, int> exit{0, 0};
+        /// Exits besides `exit` in mazes with several
+        std::vector<std::pair<int, int>> extra_exits;
+    };
+
+    /// Right and bottom walls of one row; the pointers are valid until the stream resumes
+    struct WallRow {
+        int index = 0;
+        int cols = 0;
+        const bool* vWalls = nullptr;
+        const bool* hWalls = nullptr;
+    };
+
+    /// Move-only handle to a suspended row producer. Nothing runs until next() is called
+    class RowStream {
+    public:
+        struct promise_type {
+            const WallRow* current = nullptr;
+            std::exception_ptr error;
+
+            RowStream get_return_object() {
+                return RowStream(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value(const WallRow& row) noexcept {
+                current = &row;
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+        };
+
+        RowStream(RowStream&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+        RowStream& operator=(RowStream&& other) noexcept {
+            if (this != &other) {
+                if (handle_) handle_.destroy();
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+        RowStream(const RowStream&) = delete;
+        RowStream& operator=(const RowStream&) = delete;
+        ~RowStream() {
+            if (handle_) handle_.destroy();
+        }
+
+        /// Runs the producer up to its next row; false once it has finished.
+        /// Exceptions thrown by the producer are rethrown here
+        bool next() {
+            if (!handle_ || handle_.done()) return false;
+            handle_.resume();
+            if (handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+            return !handle_.done();
+        }
+        const WallRow& row() const { return *handle_.promise().current; }
+
+    private:
+        explicit RowStream(const std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+}
+
+#endif //ROWSTREAM_H
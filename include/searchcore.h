@@ -0,0 +1,364 @@
+//
+// Grid search core templated over cost type, heuristic, neighbour model and storage
+//
+
+#ifndef SEARCHCORE_H
+#define SEARCHCORE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <landmarks.h>
+#include <maze.h>
+#include <memory>
+#include <pathcodec.h>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace course {
+    class ThreadPool;
+
+    /// Open sides of every cell packed in one byte, so a neighbour scan reads one byte
+    /// instead of three wall rows
+    struct OpenGrid {
+        enum Side : std::uint8_t { Up = 1, Down = 2, Left = 4, Right = 8 };
+
+        int rows = 0;
+        int cols = 0;
+        std::vector<std::uint8_t> open;
+
+        /// Rows are decoded in parallel when a pool is given
+        explicit OpenGrid(const Maze& maze, ThreadPool* pool = nullptr);
+
+        size_t cells() const { return open.size(); }
+        std::uint32_t index(const std::pair<int, int>& cell) const {
+            return static_cast<std::uint32_t>(cell.first * cols + cell.second);
+        }
+        std::pair<int, int> cell(const std::uint32_t index) const {
+            return {static_cast<int>(index / cols), static_cast<int>(index % cols)};
+        }
+    };
+
+    namespace search {
+        // Heuristics: set_goal once per query, then estimate(cell)
+
+        struct ZeroHeuristic {
+            static constexpr bool zero = true;
+            void set_goal(const OpenGrid&, std::uint32_t) {}
+            std::uint32_t estimate(std::uint32_t) const { return 0; }
+        };
+
+        /// Admissible as long as no step costs less than one
+        struct ManhattanHeuristic {
+            static constexpr bool zero = false;
+            void set_goal(const OpenGrid& grid, const std::uint32_t goal) {
+                cols_ = grid.cols;
+                goalRow_ = static_cast<int>(goal / cols_);
+                goalCol_ = static_cast<int>(goal % cols_);
+            }
+            std::uint32_t estimate(const std::uint32_t cell) const {
+                return std::abs(static_cast<int>(cell / cols_) - goalRow_) +
+                       std::abs(static_cast<int>(cell % cols_) - goalCol_);
+            }
+
+        private:
+            int cols_ = 1;
+            int goalRow_ = 0;
+            int goalCol_ = 0;
+        };
+
+        /// ALT bound from landmark tables, never weaker than Manhattan
+        struct LandmarkHeuristic {
+            static constexpr bool zero = false;
+            const Landmarks* landmarks = nullptr;
+
+            LandmarkHeuristic() = default;
+            explicit LandmarkHeuristic(const Landmarks* table) : landmarks(table) {}
+
+            void set_goal(const OpenGrid& grid, const std::uint32_t goal) {
+                manhattan_.set_goal(grid, goal);
+                landmarks->load(goal, goal_.data());
+            }
+            std::uint32_t estimate(const std::uint32_t cell) const {
+                return std::max(manhattan_.estimate(cell), landmarks->lower_bound(goal_.data(), cell));
+            }
+
+        private:
+            ManhattanHeuristic manhattan_;
+            std::array<std::uint32_t, 64> goal_{};
+        };
+
+        // Neighbour models: for_each(cell, fn(neighbour, step cost))
+
+        struct UnitNeighbors {
+            static constexpr bool unit = true;
+            const OpenGrid* grid;
+
+            template <typename Fn>
+            void for_each(const std::uint32_t cell, Fn&& fn) const {
+                const std::uint8_t sides = grid->open[cell];
+                if (sides & OpenGrid::Up) fn(cell - grid->cols, 1u);
+                if (sides & OpenGrid::Down) fn(cell + grid->cols, 1u);
+                if (sides & OpenGrid::Left) fn(cell - 1, 1u);
+                if (sides & OpenGrid::Right) fn(cell + 1, 1u);
+            }
+        };
+
+        /// Entering a cell costs its weight (at least 1)
+        struct WeightedNeighbors {
+            static constexpr bool unit = false;
+            const OpenGrid* grid;
+            const std::vector<std::uint8_t>* weights;
+
+            template <typename Fn>
+            void for_each(const std::uint32_t cell, Fn&& fn) const {
+                const std::uint8_t sides = grid->open[cell];
+                const auto& w = *weights;
+                if (sides & OpenGrid::Up) fn(cell - grid->cols, w[cell - grid->cols]);
+                if (sides & OpenGrid::Down) fn(cell + grid->cols, w[cell + grid->cols]);
+                if (sides & OpenGrid::Left) fn(cell - 1, w[cell - 1]);
+                if (sides & OpenGrid::Right) fn(cell + 1, w[cell + 1]);
+            }
+        };
+
+        /// Flat arrays over all cells, cleared in O(1) by bumping a generation stamp
+        template <typename Cost>
+        class DenseStorage {
+        public:
+            void reset(const size_t cells) {
+                if (seen_.size() != cells) {
+                    seen_.assign(cells, 0);
+                    closed_.assign(cells, 0);
+                    g_.resize(cells);
+                    parent_.resize(cells);
+                    generation_ = 0;
+                }
+                if (++generation_ == 0) {
+                    std::ranges::fill(seen_, 0);
+                    std::ranges::fill(closed_, 0);
+                    generation_ = 1;
+                }
+            }
+            bool seen(const std::uint32_t cell) const { return seen_[cell] == generation_; }
+            Cost g(const std::uint32_t cell) const { return g_[cell]; }
+            std::uint32_t parent(const std::uint32_t cell) const { return parent_[cell]; }
+            void update(const std::uint32_t cell, const Cost g, const std::uint32_t parent) {
+                seen_[cell] = generation_;
+                g_[cell] = g;
+                parent_[cell] = parent;
+            }
+            bool closed(const std::uint32_t cell) const { return closed_[cell] == generation_; }
+            void close(const std::uint32_t cell) { closed_[cell] = generation_; }
+            size_t memory_bytes() const {
+                return seen_.size() * (2 * sizeof(std::uint32_t) + sizeof(Cost) + sizeof(std::uint32_t));
+            }
+
+        private:
+            std::vector<std::uint32_t> seen_, closed_;
+            std::vector<Cost> g_;
+            std::vector<std::uint32_t> parent_;
+            std::uint32_t generation_{0};
+        };
+
+        /// Hash map of touched cells only, for searches that stay local on huge grids
+        template <typename Cost>
+        class HashStorage {
+        public:
+            void reset(size_t) { records_.clear(); }
+            bool seen(const std::uint32_t cell) const { return records_.contains(cell); }
+            Cost g(const std::uint32_t cell) const { return records_.at(cell).g; }
+            std::uint32_t parent(const std::uint32_t cell) const { return records_.at(cell).parent; }
+            void update(const std::uint32_t cell, const Cost g, const std::uint32_t parent) {
+                Record& record = records_[cell];
+                record.g = g;
+                record.parent = parent;
+            }
+            bool closed(const std::uint32_t cell) const {
+                const auto it = records_.find(cell);
+                return it != records_.end() && it->second.closed;
+            }
+            void close(const std::uint32_t cell) { records_[cell].closed = true; }
+            size_t memory_bytes() const { return records_.size() * (sizeof(Record) + 2 * sizeof(void*)); }
+
+        private:
+            struct Record {
+                Cost g{};
+                std::uint32_t parent{0};
+                bool closed{false};
+            };
+            std::unordered_map<std::uint32_t, Record> records_;
+        };
+    }
+
+    /// Best-first search specialised at compile time. Integral costs pack (f, cell) into one
+    /// 64-bit heap key; a zero heuristic with unit steps becomes a plain FIFO breadth-first search
+    template <typename Cost, typename Heuristic, typename Neighbors, template <typename> class Storage>
+    class SearchCore {
+    public:
+        explicit SearchCore(Neighbors neighbors, Heuristic heuristic = {})
+            : neighbors_(neighbors), heuristic_(heuristic) {}
+
+        PathCodec find_path(const std::pair<int, int>& start, const std::pair<int, int>& goal);
+
+        /// Cells closed by the last search
+        size_t expanded() const { return expanded_; }
+        /// Cost of the last path found
+        Cost cost() const { return cost_; }
+        size_t memory_bytes() const { return storage_.memory_bytes(); }
+
+    private:
+        using Entry = std::conditional_t<std::is_integral_v<Cost>, std::uint64_t, std::pair<Cost, std::uint32_t>>;
+
+        Neighbors neighbors_;
+        Heuristic heuristic_;
+        Storage<Cost> storage_;
+        std::vector<Entry> heap_;
+        std::vector<std::uint32_t> queue_;
+        size_t expanded_{0};
+        Cost cost_{};
+
+        static Entry make_entry(const Cost f, const std::uint32_t cell) {
+            if constexpr (std::is_integral_v<Cost>) return static_cast<std::uint64_t>(f) << 32 | cell;
+            else return {f, cell};
+        }
+        static std::uint32_t entry_cell(const Entry& entry) {
+            if constexpr (std::is_integral_v<Cost>) return static_cast<std::uint32_t>(entry);
+            else return entry.second;
+        }
+        bool breadth_first(std::uint32_t source, std::uint32_t target);
+        bool best_first(std::uint32_t source, std::uint32_t target);
+    };
+
+    template <typename Cost, typename Heuristic, typename Neighbors, template <typename> class Storage>
+    PathCodec SearchCore<Cost, Heuristic, Neighbors, Storage>::find_path(const std::pair<int, int>& start,
+                                                                         const std::pair<int, int>& goal) {
+        const OpenGrid& grid = *neighbors_.grid;
+        const std::uint32_t source = grid.index(start);
+        const std::uint32_t target = grid.index(goal);
+        expanded_ = 0;
+        cost_ = Cost{};
+        storage_.reset(grid.cells());
+        storage_.update(source, Cost{}, source);
+
+        bool found;
+        if constexpr (Heuristic::zero && Neighbors::unit) found = breadth_first(source, target);
+        else found = best_first(source, target);
+        if (!found) return {};
+
+        cost_ = storage_.g(target);
+        std::vector<std::pair<int, int>> cells;
+        for (std::uint32_t cell = target; ; cell = storage_.parent(cell)) {
+            cells.push_back(grid.cell(cell));
+            if (cell == source) break;
+        }
+        std::ranges::reverse(cells);
+        return PathCodec(cells);
+    }
+
+    template <typename Cost, typename Heuristic, typename Neighbors, template <typename> class Storage>
+    bool SearchCore<Cost, Heuristic, Neighbors, Storage>::breadth_first(const std::uint32_t source,
+                                                                        const std::uint32_t target) {
+        queue_.clear();
+        queue_.push_back(source);
+        for (size_t head = 0; head < queue_.size(); head++) {
+            const std::uint32_t cell = queue_[head];
+            expanded_++;
+            if (cell == target) return true;
+
+            const Cost next_g = storage_.g(cell) + 1;
+            neighbors_.for_each(cell, [&](const std::uint32_t next, std::uint32_t) {
+                if (storage_.seen(next)) return;
+                storage_.update(next, next_g, cell);
+                queue_.push_back(next);
+            });
+        }
+        return false;
+    }
+
+    template <typename Cost, typename Heuristic, typename Neighbors, template <typename> class Storage>
+    bool SearchCore<Cost, Heuristic, Neighbors, Storage>::best_first(const std::uint32_t source,
+                                                                     const std::uint32_t target) {
+        heuristic_.set_goal(*neighbors_.grid, target);
+        heap_.clear();
+        heap_.push_back(make_entry(static_cast<Cost>(heuristic_.estimate(source)), source));
+
+        while (!heap_.empty()) {
+            std::ranges::pop_heap(heap_, std::greater<>());
+            const std::uint32_t cell = entry_cell(heap_.back());
+            heap_.pop_back();
+            if (storage_.closed(cell)) continue;
+            storage_.close(cell);
+            expanded_++;
+            if (cell == target) return true;
+
+            const Cost g = storage_.g(cell);
+            neighbors_.for_each(cell, [&](const std::uint32_t next, const std::uint32_t step) {
+                const Cost next_g = g + static_cast<Cost>(step);
+                if (storage_.closed(next) || (storage_.seen(next) && storage_.g(next) <= next_g)) return;
+                storage_.update(next, next_g, cell);
+                heap_.push_back(make_entry(next_g + static_cast<Cost>(heuristic_.estimate(next)), next));
+                std::ranges::push_heap(heap_, std::greater<>());
+            });
+        }
+        return false;
+    }
+
+    namespace search {
+        using UnitBfs = SearchCore<std::uint32_t, ZeroHeuristic, UnitNeighbors, DenseStorage>;
+        using ManhattanAstar = SearchCore<std::uint32_t, ManhattanHeuristic, UnitNeighbors, DenseStorage>;
+        using WeightedAstar = SearchCore<std::uint32_t, ManhattanHeuristic, WeightedNeighbors, DenseStorage>;
+        using SparseAstar = SearchCore<std::uint32_t, ManhattanHeuristic, UnitNeighbors, HashStorage>;
+        using AltAstar = SearchCore<std::uint32_t, LandmarkHeuristic, UnitNeighbors, DenseStorage>;
+    }
+
+    extern template class SearchCore<std::uint32_t, search::ZeroHeuristic, search::UnitNeighbors, search::DenseStorage>;
+    extern template class SearchCore<std::uint32_t, search::ManhattanHeuristic, search::UnitNeighbors, search::DenseStorage>;
+    extern template class SearchCore<std::uint32_t, search::ManhattanHeuristic, search::WeightedNeighbors, search::DenseStorage>;
+    extern template class SearchCore<std::uint32_t, search::ManhattanHeuristic, search::UnitNeighbors, search::HashStorage>;
+    extern template class SearchCore<std::uint32_t, search::LandmarkHeuristic, search::UnitNeighbors, search::DenseStorage>;
+
+    /// Owns the grid and weights and picks an instantiation by name at run time
+    class PolicySolver {
+    public:
+        struct Result {
+            PathCodec path;
+            std::uint64_t cost = 0;
+            size_t expanded = 0;
+        };
+
+        /// Weights for the weighted solver are 1..max_weight, derived from the seed
+        explicit PolicySolver(const Maze& maze, std::uint64_t weight_seed = 1, int max_weight = 9);
+
+        // Solvers point into grid_ and weights_
+        PolicySolver(const PolicySolver&) = delete;
+        PolicySolver& operator=(const PolicySolver&) = delete;
+
+        /// bfs, astar, weighted, astar_sparse, alt
+        static const std::vector<std::string>& names();
+        /// Landmark preprocessing for alt; done with 8 farthest landmarks on first use otherwise
+        void use_landmarks(int count, unsigned threads = 1,
+                           Landmarks::Selection selection = Landmarks::Selection::Farthest);
+        const Landmarks* landmarks() const { return landmarks_.get(); }
+        Result solve(const std::string& name, const std::pair<int, int>& start, const std::pair<int, int>& goal);
+
+        std::uint8_t weight(const std::pair<int, int>& cell) const { return weights_[grid_.index(cell)]; }
+
+    private:
+        const Maze& maze_;
+        OpenGrid grid_;
+        std::vector<std::uint8_t> weights_;
+        search::UnitBfs bfs_;
+        search::ManhattanAstar astar_;
+        search::WeightedAstar weighted_;
+        search::SparseAstar sparse_;
+        std::unique_ptr<Landmarks> landmarks_;
+        search::AltAstar alt_;
+    };
+}
+
+#endif //SEARCHCORE_H
@@ -0,0 +1,80 @@
+//
+// On-disk cache of solved paths keyed by maze content hash and endpoints
+//
+
+#ifndef SOLUTIONCACHE_H
+#define SOLUTIONCACHE_H
+
+#include <cstdint>
+#include <optional>
+#include <pathcodec.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace course {
+    class Maze;
+
+    /// Text file of at most max_entries solutions, least recently used evicted first.
+    /// Entries are parsed only up to their key; paths are decoded on a hit. Hits update
+    /// recency in memory and are written out only together with a store
+    class SolutionCache {
+    public:
+        struct Key {
+            std::uint64_t maze_hash = 0;
+            std::pair<int, int> start;
+            std::pair<int, int> goal;
+
+            bool operator==(const Key& other) const = default;
+        };
+
+        struct Solution {
+            PathCodec path;
+            /// Solve time measured when the entry was stored
+            double seconds = 0.0;
+            /// Timed runs that seconds is the median of; 1 for a single cold solve
+            std::uint32_t runs = 1;
+        };
+
+        explicit SolutionCache(std::string filename = "maze_solutions.cache", size_t max_entries = 256);
+        /// Writes pending changes; errors are ignored so a broken cache never fails a solve
+        ~SolutionCache();
+
+        SolutionCache(const SolutionCache&) = delete;
+        SolutionCache& operator=(const SolutionCache&) = delete;
+
+        /// Key for entrance to exit of the maze
+        static Key key_of(const Maze& maze);
+
+        std::optional<Solution> find(const Key& key);
+        void store(const Key& key, const PathCodec& path, double seconds, std::uint32_t runs = 1);
+        void flush();
+
+        size_t size();
+        std::uint64_t hits() const { return hits_; }
+        std::uint64_t misses() const { return misses_; }
+
+    private:
+        struct Entry {
+            Key key;
+            std::uint64_t last_used = 0;
+            double seconds = 0.0;
+            std::uint32_t runs = 1;
+            /// PathCodec record, decoded on demand
+            std::string record;
+        };
+
+        std::string filename_;
+        size_t maxEntries_;
+        std::vector<Entry> entries_;
+        std::uint64_t clock_{0};
+        std::uint64_t hits_{0};
+        std::uint64_t misses_{0};
+        bool loaded_{false};
+        bool dirty_{false};
+
+        void load();
+    };
+}
+
+#endif //SOLUTIONCACHE_H
@@ -0,0 +1,27 @@
+//
+// SplitMix64 steps shared by the generators, seed derivation and hashing
+//
+
+#ifndef SPLITMIX_H
+#define SPLITMIX_H
+
+#include <cstdint>
+
+namespace course {
+    /// Golden-ratio increment between consecutive SplitMix64 states
+    constexpr std::uint64_t SPLITMIX64_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    /// SplitMix64 finalizer: a bijective mix in which every input bit affects every output bit
+    constexpr std::uint64_t splitmix64_mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /// Advances state by SPLITMIX64_GAMMA and returns the mixed new state
+    constexpr std::uint64_t splitmix64(std::uint64_t& state) {
+        return splitmix64_mix(state += SPLITMIX64_GAMMA);
+    }
+}
+
+#endif //SPLITMIX_H
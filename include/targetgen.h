@@ -0,0 +1,51 @@
+//
+// Parallel candidate generation until a maze meets a difficulty target
+//
+
+#ifndef TARGETGEN_H
+#define TARGETGEN_H
+
+#include <analysis.h>
+#include <cstdint>
+#include <maze.h>
+#include <string>
+
+namespace course {
+    struct TargetOptions {
+        std::string algo = "eller";
+        /// Accept a maze whose solution is at least this many steps
+        std::uint64_t min_path = 0;
+        /// ... and whose dead ends are at least this fraction of the cells
+        double min_dead_ends = 0.0;
+        /// Score and keep candidates with the endpoints moved to farthest_border_pair
+        bool farthest = false;
+        unsigned threads = 1;
+        /// Candidate i is generated from a seed mixed from (seed, i)
+        std::uint64_t seed = 0;
+        std::uint64_t max_candidates = 1000000;
+    };
+
+    struct TargetResult {
+        bool found = false;
+        /// Winning candidate index and the seed it was generated from
+        std::uint64_t candidate = 0;
+        std::uint64_t seed = 0;
+        /// Candidates generated and scored, including ones finished after the winner
+        std::uint64_t scored = 0;
+        /// Longest solution among the scored candidates
+        std::uint64_t best_path = 0;
+        MazeAnalysis analysis;
+        double seconds = 0.0;
+    };
+
+    /// Seed used for candidate i of a search from base
+    std::uint64_t candidate_seed(std::uint64_t base, std::uint64_t candidate);
+
+    /// Every thread generates and scores candidates into its own Maze with one linear
+    /// analysis pass. Indices are handed out in order and none are started past the first
+    /// match, so the winner is the lowest matching index whatever the thread count.
+    /// On success `maze` holds the winner
+    TargetResult generate_target(Maze& maze, int rows, int cols, const TargetOptions& options);
+}
+
+#endif //TARGETGEN_H
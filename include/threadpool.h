@@ -0,0 +1,48 @@
+//
+// Fixed set of worker threads reused across parallel phases
+//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace course {
+    class ThreadPool {
+    public:
+        /// threads counts the calling thread, which always takes part in the work
+        explicit ThreadPool(unsigned threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+        /// Runs fn(worker) once on every thread and waits; worker 0 is the caller
+        void run_on_all(const std::function<void(unsigned)>& fn);
+        /// Runs fn(i) for every i in [0, count), handing out indices dynamically
+        void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+
+    private:
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable start_;
+        std::condition_variable done_;
+        const std::function<void(unsigned)>* task_{nullptr};
+        std::exception_ptr error_;
+        unsigned long generation_{0};
+        unsigned pending_{0};
+        bool stop_{false};
+
+        void worker_loop(unsigned id);
+    };
+}
+
+#endif //THREADPOOL_H
@@ -0,0 +1,64 @@
+//
+// Bounded LRU cache of wall tiles over a tiled maze file
+//
+
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+#include <cstdint>
+#include <list>
+#include <tiled.h>
+#include <unordered_map>
+
+namespace course {
+    struct TileCacheStats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t bytes_read = 0;
+        size_t peak_bytes = 0;
+
+        double hit_rate() const {
+            const auto total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+        }
+    };
+
+    class TileCache {
+    public:
+        TileCache(TiledMazeReader& reader, size_t capacity_bytes);
+
+        int getRows() const { return reader_.getRows(); }
+        int getCols() const { return reader_.getCols(); }
+        int tile_size() const { return reader_.tile_size(); }
+
+        /// Wall to the right of / below a cell, paging its tile in when needed
+        bool v_wall(const int row, const int col) {
+            const WallTile& tile = tile_for(row, col);
+            return tile.v_wall(row - tile.row0, col - tile.col0);
+        }
+        bool h_wall(const int row, const int col) {
+            const WallTile& tile = tile_for(row, col);
+            return tile.h_wall(row - tile.row0, col - tile.col0);
+        }
+
+        TileCacheStats stats() const;
+        size_t capacity() const { return capacity_; }
+
+    private:
+        TiledMazeReader& reader_;
+        size_t capacity_;
+        size_t bytes_{0};
+        std::list<std::pair<std::int64_t, WallTile>> lru_;
+        std::unordered_map<std::int64_t, std::list<std::pair<std::int64_t, WallTile>>::iterator> index_;
+        TileCacheStats stats_;
+
+        // Most recently used tile, checked first to skip the hash lookup
+        std::int64_t lastKey_{-1};
+        const WallTile* last_{nullptr};
+
+        const WallTile& tile_for(int row, int col);
+    };
+}
+
+#endif //TILECACHE_H
@@ -0,0 +1,127 @@
+//
+// Tiled, compressed on-disk maze format with random access to regions
+//
+// Layout (little-endian):
+//   header    "MZT1", rows, cols, tile size, entrance row/col, exit row/col (32 bytes)
+//   directory one 16-byte entry per tile in row-major order: offset, size, codec
+//   payloads  per tile: right-wall plane then bottom-wall plane, bit-packed
+//             row by row in 64-bit words, compressed independently
+//   footer    only in mazes with several exits, after the last payload:
+//             "MZX1", count, then row/col of each exit besides the header's
+//
+
+#ifndef TILED_H
+#define TILED_H
+
+#include <cstdint>
+#include <fstream>
+#include <maze.h>
+#include <string>
+#include <vector>
+
+namespace course {
+    class Generator;
+
+    /// PackBits-style run-length codec for tile payloads
+    class TileCodec {
+    public:
+        enum Method : std::uint8_t { Stored = 0, RunLength = 1 };
+
+        static std::vector<std::uint8_t> compress(const std::uint8_t* data, size_t size);
+        static void decompress(const std::uint8_t* data, size_t size, std::uint8_t* out, size_t out_size);
+    };
+
+    /// Right and bottom walls of one tile, bit-packed row by row
+    struct WallTile {
+        int row0 = 0;
+        int col0 = 0;
+        int rows = 0;
+        int cols = 0;
+        /// 64-bit words per tile row in each plane
+        int stride = 0;
+        std::vector<std::uint64_t> vBits;
+        std::vector<std::uint64_t> hBits;
+
+        /// Coordinates are relative to the tile origin
+        bool v_wall(const int row, const int col) const {
+            return vBits[static_cast<size_t>(row) * stride + (col >> 6)] >> (col & 63) & 1;
+        }
+        bool h_wall(const int row, const int col) const {
+            return hBits[static_cast<size_t>(row) * stride + (col >> 6)] >> (col & 63) & 1;
+        }
+        size_t memory_bytes() const { return (vBits.size() + hBits.size()) * sizeof(std::uint64_t); }
+    };
+
+    /// Streams rows into tiles; only one band of tile_size rows is kept in memory
+    class TiledMazeWriter {
+    public:
+        TiledMazeWriter(const std::string& filename, int rows, int cols, int tile_size = 256);
+
+        void set_entrance(int row, int col) { entrance_ = {row, col}; }
+        void set_exit(int row, int col) { exit_ = {row, col}; }
+        void add_exit(int row, int col) { extraExits_.emplace_back(row, col); }
+        void push_row(const bool* vWalls, const bool* hWalls);
+        void finish();
+
+    private:
+        std::ofstream file_;
+        int rows_, cols_, tile_;
+        int tilesX_, tilesY_;
+        int rowWords_;
+        int bandRows_{0};
+        int rowsWritten_{0};
+        std::pair<int, int> entrance_;
+        std::pair<int, int> exit_;
+        std::vector<std::pair<int, int>> extraExits_;
+        std::vector<std::uint64_t> vBand_, hBand_;
+        std::vector<std::uint8_t> directory_;
+
+        void flush_band();
+    };
+
+    /// Reads the header eagerly, directory entries and tiles only on demand
+    class TiledMazeReader {
+    public:
+        explicit TiledMazeReader(const std::string& filename);
+
+        int getRows() const { return rows_; }
+        int getCols() const { return cols_; }
+        int tile_size() const { return tile_; }
+        int tiles_x() const { return tilesX_; }
+        int tiles_y() const { return tilesY_; }
+        auto get_entrance() const { return entrance_; }
+        auto get_exit() const { return exit_; }
+        /// Exits besides get_exit(), from the footer
+        const std::vector<std::pair<int, int>>& get_extra_exits() const { return extraExits_; }
+        MazeShape shape() const { return {rows_, cols_, entrance_, exit_, extraExits_}; }
+        /// Directory entries and payloads read by load_tile; the header and footer read
+        /// on open are not counted
+        std::uint64_t bytes_read() const { return bytesRead_; }
+        std::uint64_t tiles_read() const { return tilesRead_; }
+
+        WallTile load_tile(int tile_row, int tile_col);
+        /// Loads the window clipped to the maze; entrance/exit are kept if inside it
+        void load_region(Maze& out, int row, int col, int rows, int cols);
+
+    private:
+        std::ifstream file_;
+        int rows_{0}, cols_{0}, tile_{0};
+        int tilesX_{0}, tilesY_{0};
+        std::pair<int, int> entrance_;
+        std::pair<int, int> exit_;
+        std::vector<std::pair<int, int>> extraExits_;
+        std::uint64_t bytesRead_{0};
+        std::uint64_t tilesRead_{0};
+
+        void read_bytes(std::uint64_t offset, std::uint8_t* out, size_t size, bool counted = true);
+        void read_footer();
+    };
+
+    void save_tiled(Maze& maze, const std::string& filename, int tile_size = 256);
+    /// Generates straight to disk, compressing tiles on a second thread. Generators that
+    /// stream rows never hold a Maze in memory; the others stream from an in-memory maze
+    void generate_tiled(const Generator& generator, int rows, int cols, std::uint64_t seed,
+                        const std::string& filename, int tile_size = 256, unsigned threads = 1);
+}
+
+#endif //TILED_H
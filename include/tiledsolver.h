@@ -0,0 +1,51 @@
+//
+// Out-of-core A* over a tiled maze, walls paged through a TileCache
+//
+
+#ifndef TILEDSOLVER_H
+#define TILEDSOLVER_H
+
+#include <cstdint>
+#include <pathcodec.h>
+#include <tilecache.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace course {
+    class TiledAstar {
+    public:
+        struct Stats {
+            std::uint64_t expanded = 0;
+            size_t peak_open = 0;
+            /// Bytes held by the sparse per-tile search state
+            size_t state_bytes = 0;
+            std::uint64_t state_tiles = 0;
+        };
+
+        explicit TiledAstar(TileCache& cache) : cache_(cache) {}
+
+        PathCodec find_path(const std::pair<int, int>& start, const std::pair<int, int>& goal);
+        const Stats& stats() const { return stats_; }
+
+    private:
+        // Closed bit and 2-bit arrival direction per cell, allocated only for
+        // tiles the search reaches so memory follows the explored area
+        struct TileState {
+            std::vector<std::uint64_t> closed;
+            std::vector<std::uint64_t> parent;
+        };
+
+        TileCache& cache_;
+        std::unordered_map<std::int64_t, TileState> state_;
+        Stats stats_;
+
+        TileState& state_for(int row, int col);
+        bool is_closed(int row, int col);
+        void close(int row, int col, int dir);
+        int parent_dir(int row, int col);
+        bool can_move(int row, int col, int dir);
+    };
+}
+
+#endif //TILEDSOLVER_H
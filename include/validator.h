@@ -0,0 +1,64 @@
+//
+// Perfect-maze validation: edges, connectivity, cycles, borders and openings
+//
+
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <maze.h>
+#include <string>
+#include <vector>
+
+namespace course {
+    struct ValidationReport {
+        std::uint64_t cells = 0;
+        std::uint64_t open_edges = 0;
+        std::uint64_t components = 0;
+        /// Open edges that close a loop; a perfect maze has none
+        std::uint64_t cycles = 0;
+        /// Border walls that are open without an entrance or exit behind them
+        std::uint64_t border_gaps = 0;
+        std::vector<std::string> problems;
+        double seconds = 0.0;
+
+        /// Connected, acyclic, closed borders and valid entrance/exit
+        bool perfect() const { return problems.empty(); }
+        void print(std::ostream& out) const;
+    };
+
+    /// Streaming check: rows are pushed top to bottom and packed 64 cells per word.
+    /// Components are tracked with a union-find over the current row only, so memory is O(cols)
+    class RowValidator {
+    public:
+        explicit RowValidator(const MazeShape& shape);
+
+        void push_row(const bool* vWalls, const bool* hWalls);
+        /// Completes the report; call once after the last row. The reported time covers
+        /// push_row and finish only, not whatever produced the rows
+        ValidationReport finish();
+
+    private:
+        MazeShape shape_;
+        ValidationReport report_;
+        int row_{0};
+        size_t words_;
+        std::vector<std::uint64_t> right_, down_;
+        std::vector<std::uint32_t> prevLabel_, nextLabel_, compact_;
+        std::vector<std::uint32_t> parent_;
+        std::vector<std::uint8_t> carried_;
+        std::uint32_t prevCount_{0};
+
+        std::uint32_t find(std::uint32_t x);
+        bool unite(std::uint32_t a, std::uint32_t b);
+        bool right_opening(int row) const;
+        bool bottom_opening(int col) const;
+    };
+
+    /// One row-by-row pass of RowValidator over a maze in memory
+    ValidationReport validate_maze(const Maze& maze);
+}
+
+#endif //VALIDATOR_H
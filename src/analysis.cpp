@@ -0,0 +1,309 @@
+//
+// Maze analytics: degree census, solution length, diameter and corridor shape
+//
+
+#include <analysis.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+#include <tilecache.h>
+#include <tiled.h>
+
+namespace course {
+    namespace {
+        // Up, Down, Left, Right as in PathCodec::Move
+        constexpr int DR[] = {-1, 1, 0, 0};
+        constexpr int DC[] = {0, 0, -1, 1};
+        constexpr int OPPOSITE[] = {1, 0, 3, 2};
+
+        struct MatrixWalls {
+            const Maze& maze;
+            bool right(const int row, const int col) const { return maze.get_v_walls()(row, col); }
+            bool down(const int row, const int col) const { return maze.get_h_walls()(row, col); }
+        };
+
+        struct CachedWalls {
+            TileCache& cache;
+            bool right(const int row, const int col) const { return cache.v_wall(row, col); }
+            bool down(const int row, const int col) const { return cache.h_wall(row, col); }
+        };
+
+        // The outer border is a wall even where the entrance or exit opens it
+        template <typename Walls>
+        bool is_open(const Walls& walls, const int rows, const int cols, const int row, const int col, const int dir) {
+            switch (dir) {
+                case 0: return row > 0 && !walls.down(row - 1, col);
+                case 1: return row < rows - 1 && !walls.down(row, col);
+                case 2: return col > 0 && !walls.right(row, col - 1);
+                default: return col < cols - 1 && !walls.right(row, col);
+            }
+        }
+
+        struct Census {
+            std::uint64_t open_edges = 0;
+            std::uint64_t dead_ends = 0;
+            std::uint64_t corridor_cells = 0;
+            std::uint64_t junctions = 0;
+        };
+
+        template <typename Walls>
+        void census(const Walls& walls, const int rows, const int cols, const int row0, const int row1, Census& out) {
+            for (int r = row0; r < row1; r++) {
+                for (int c = 0; c < cols; c++) {
+                    const bool right = is_open(walls, rows, cols, r, c, 3);
+                    const bool down = is_open(walls, rows, cols, r, c, 1);
+                    const int degree = right + down + is_open(walls, rows, cols, r, c, 0) +
+                                       is_open(walls, rows, cols, r, c, 2);
+                    out.open_edges += right + down;
+                    if (degree == 1) out.dead_ends++;
+                    else if (degree == 2) out.corridor_cells++;
+                    else if (degree >= 3) out.junctions++;
+                }
+            }
+        }
+
+        // 4 bits per cell, 16 per word: 0 unvisited, 1 + direction to the parent, ROOT
+        class CellStates {
+        public:
+            static constexpr unsigned ROOT = 5;
+
+            explicit CellStates(const std::uint64_t cells) : words_((cells + 15) / 16) {}
+
+            unsigned get(const std::uint64_t i) const { return words_[i >> 4] >> ((i & 15) * 4) & 15; }
+            void set(const std::uint64_t i, const unsigned value) {
+                const unsigned shift = (i & 15) * 4;
+                words_[i >> 4] = (words_[i >> 4] & ~(std::uint64_t{15} << shift)) |
+                                 static_cast<std::uint64_t>(value) << shift;
+            }
+            void clear() { std::ranges::fill(words_, 0); }
+            size_t bytes() const { return words_.size() * sizeof(std::uint64_t); }
+
+        private:
+            std::vector<std::uint64_t> words_;
+        };
+
+        // Iterative depth-first walk from root without a stack: a cell's state holds the
+        // direction to its parent, and returning from a child resumes the parent's scan at
+        // the side after it. Only a depth counter and the current corridor length are kept.
+        // With stats it also fills the census of the walk; returns the deepest cell
+        template <typename Walls>
+        std::pair<int, int> sweep(const Walls& walls, const MazeShape& shape, const std::pair<int, int> root,
+                                  CellStates& state, MazeAnalysis* stats, std::uint64_t& peak) {
+            const int rows = shape.rows;
+            const int cols = shape.cols;
+            const auto index = [cols](const int r, const int c) { return static_cast<std::uint64_t>(r) * cols + c; };
+            const auto passage = [&](const int r, const int c) {
+                int sides = 0;
+                for (int d = 0; d < 4; d++)
+                    sides += is_open(walls, rows, cols, r, c, d);
+                return sides == 2;
+            };
+
+            auto [r, c] = root;
+            std::pair<int, int> farthest = root;
+            std::uint64_t depth = 0;
+            std::uint64_t backEdges = 0;
+            // Cells since the last dead end or junction on the path to here
+            std::uint32_t corridor = 0;
+            int next = 0;
+            peak = 0;
+
+            state.set(index(r, c), CellStates::ROOT);
+            if (stats) {
+                stats->reached = 1;
+                if (root == shape.exit) stats->solution_length = 0;
+            }
+
+            while (true) {
+                const unsigned here = state.get(index(r, c));
+                const int up = here == CellStates::ROOT ? -1 : static_cast<int>(here) - 1;
+                int d = next;
+                for (; d < 4; d++) {
+                    if (d == up || !is_open(walls, rows, cols, r, c, d)) continue;
+                    if (state.get(index(r + DR[d], c + DC[d])) == 0) break;
+                    // Seen from both ends, so every loop is counted twice
+                    backEdges++;
+                }
+
+                if (d < 4) {
+                    r += DR[d];
+                    c += DC[d];
+                    state.set(index(r, c), 1 + OPPOSITE[d]);
+                    next = 0;
+                    if (++depth > peak) {
+                        peak = depth;
+                        farthest = {r, c};
+                    }
+                    if (stats) {
+                        corridor++;
+                        if (!passage(r, c)) {
+                            const auto bucket = static_cast<size_t>(std::bit_width(corridor) - 1);
+                            if (stats->corridor_histogram.size() <= bucket) stats->corridor_histogram.resize(bucket + 1);
+                            stats->corridor_histogram[bucket]++;
+                            corridor = 0;
+                        }
+                        stats->reached++;
+                        if (std::pair{r, c} == shape.exit) stats->solution_length = depth;
+                    }
+                    continue;
+                }
+
+                // Every side done: back to the parent, after the side that led here
+                if (up < 0) break;
+                r += DR[up];
+                c += DC[up];
+                depth--;
+                next = OPPOSITE[up] + 1;
+                // A passage has nothing left to try once its child returns, so the corridor
+                // only matters again at the root or at a dead end or junction
+                if (stats && (state.get(index(r, c)) == CellStates::ROOT || !passage(r, c))) corridor = 0;
+            }
+
+            if (stats) stats->cycles = backEdges / 2;
+            return farthest;
+        }
+
+        // The first sweep from the entrance gathers the statistics and finds the deepest cell;
+        // the deepest cell from there gives the diameter, exact when the maze is a tree
+        template <typename Walls>
+        void walk(const Walls& walls, const MazeShape& shape, MazeAnalysis& result) {
+            CellStates state(result.cells);
+            const auto far = sweep(walls, shape, shape.entrance, state, &result, result.max_depth);
+            state.clear();
+            sweep(walls, shape, far, state, nullptr, result.diameter);
+            result.state_bytes = state.bytes();
+        }
+
+        // Census on worker threads while the walk runs on the calling thread
+        template <typename MakeWalls, typename Walk>
+        void run(const MazeShape& shape, const unsigned threads, MazeAnalysis& result, MakeWalls make_walls, Walk walk_fn) {
+            const auto start = std::chrono::steady_clock::now();
+            result.rows = shape.rows;
+            result.cols = shape.cols;
+            result.cells = static_cast<std::uint64_t>(shape.rows) * shape.cols;
+            if (result.cells == 0) return;
+
+            const int parts = static_cast<int>(std::clamp<unsigned>(threads, 1, static_cast<unsigned>(shape.rows)));
+            std::vector<Census> counts(parts);
+            const auto census_part = [&](const int part) {
+                make_walls([&](const auto& walls) {
+                    census(walls, shape.rows, shape.cols, shape.rows * part / parts,
+                           shape.rows * (part + 1) / parts, counts[part]);
+                });
+            };
+
+            if (threads > 1) {
+                std::vector<std::thread> pool;
+                for (int part = 0; part < parts; part++)
+                    pool.emplace_back(census_part, part);
+                walk_fn();
+                for (auto& thread : pool)
+                    thread.join();
+            } else {
+                census_part(0);
+                walk_fn();
+            }
+
+            for (const auto& part : counts) {
+                result.open_edges += part.open_edges;
+                result.dead_ends += part.dead_ends;
+                result.corridor_cells += part.corridor_cells;
+                result.junctions += part.junctions;
+            }
+
+            // Dead ends at the entrance or exit end the solution, not a side branch
+            if (result.solution_length != MazeAnalysis::NONE) {
+                std::uint64_t branches = result.dead_ends;
+                make_walls([&](const auto& walls) {
+                    for (const auto& [r, c] : {shape.entrance, shape.exit}) {
+                        int open = 0;
+                        for (int d = 0; d < 4; d++)
+                            open += is_open(walls, shape.rows, shape.cols, r, c, d);
+                        if (open == 1 && branches > 0) branches--;
+                    }
+                });
+                if (shape.entrance == shape.exit && branches < result.dead_ends) branches++;
+                const std::uint64_t side = result.reached - (result.solution_length + 1);
+                result.river_factor = branches ? static_cast<double>(side) / static_cast<double>(branches) : 0.0;
+            }
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    MazeAnalysis analyze_maze(const Maze& maze, const unsigned threads) {
+        MazeAnalysis result;
+        const MatrixWalls walls{maze};
+        run(maze.shape(), threads, result,
+            [&](const auto& fn) { fn(walls); },
+            [&] { walk(walls, maze.shape(), result); });
+        return result;
+    }
+
+    // Every thread pages tiles through its own reader and cache
+    MazeAnalysis analyze_tiled(const std::string& filename, const unsigned threads, const size_t cache_bytes) {
+        MazeAnalysis result;
+        TiledMazeReader reader(filename);
+        const MazeShape shape = reader.shape();
+        run(shape, threads, result,
+            [&](const auto& fn) {
+                TiledMazeReader own(filename);
+                TileCache cache(own, cache_bytes);
+                fn(CachedWalls{cache});
+            },
+            [&] {
+                TileCache cache(reader, cache_bytes);
+                walk(CachedWalls{cache}, shape, result);
+            });
+        return result;
+    }
+
+    void MazeAnalysis::print(std::ostream& out) const {
+        const auto percent = [this](const std::uint64_t count) {
+            return cells ? 100.0 * static_cast<double>(count) / static_cast<double>(cells) : 0.0;
+        };
+
+        out << "Maze analysis: " << rows << "x" << cols << ", " << cells << " cells\n" << std::fixed;
+        out << "  Dead ends:      " << dead_ends << " (" << std::setprecision(1) << percent(dead_ends) << "%)\n";
+        out << "  Corridor cells: " << corridor_cells << " (" << percent(corridor_cells) << "%)\n";
+        out << "  Junctions:      " << junctions << " (" << percent(junctions) << "%)\n";
+        out << "  Solution:       ";
+        if (solution_length == NONE) out << "exit unreachable\n";
+        else out << solution_length << " steps (" << percent(solution_length + 1) << "% of cells)\n";
+        out << "  Diameter:       " << diameter << " steps\n";
+        out << "  River factor:   " << std::setprecision(2) << river_factor << " cells per dead-end branch\n";
+        out << "  Reached:        " << reached << " of " << cells << " cells, " << cycles << " loops\n";
+
+        out << "  Corridor lengths:\n";
+        std::uint64_t peak = 1;
+        for (const auto count : corridor_histogram)
+            peak = std::max(peak, count);
+        for (size_t k = 0; k < corridor_histogram.size(); k++) {
+            const std::uint64_t low = std::uint64_t{1} << k;
+            const std::string range = low == 1 ? "1" : std::to_string(low) + "-" + std::to_string(2 * low - 1);
+            out << "    " << std::left << std::setw(12) << range << std::right << std::setw(12) << corridor_histogram[k]
+                << "  " << std::string(static_cast<size_t>(40.0 * corridor_histogram[k] / peak + 0.5), '#') << "\n";
+        }
+        out << "  Walk state: " << std::setprecision(1) << state_bytes / 1024.0 << " KiB, peak depth "
+            << max_depth << ", " << std::setprecision(2) << seconds * 1e3 << " ms\n";
+    }
+
+    void MazeAnalysis::print_json(std::ostream& out) const {
+        out << "{\"rows\": " << rows << ", \"cols\": " << cols << ", \"cells\": " << cells
+            << ", \"open_edges\": " << open_edges << ", \"dead_ends\": " << dead_ends
+            << ", \"corridor_cells\": " << corridor_cells << ", \"junctions\": " << junctions
+            << ", \"solution_length\": ";
+        if (solution_length == NONE) out << "null";
+        else out << solution_length;
+        out << ", \"diameter\": " << diameter << ", \"river_factor\": " << std::fixed << std::setprecision(4)
+            << river_factor << ", \"reached\": " << reached << ", \"cycles\": " << cycles
+            << ", \"corridor_histogram\": [";
+        for (size_t k = 0; k < corridor_histogram.size(); k++)
+            out << (k ? ", " : "") << "{\"min\": " << (std::uint64_t{1} << k) << ", \"count\": " << corridor_histogram[k] << "}";
+        out << "], \"max_depth\": " << max_depth << ", \"state_bytes\": " << state_bytes
+            << ", \"seconds\": " << std::setprecision(6) << seconds << "}\n";
+    }
+}
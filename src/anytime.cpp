@@ -0,0 +1,133 @@
+//
+// Interruptible A*: bounded slices under a deadline, node budget or cancellation token
+//
+
+#include <anytime.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+
+namespace course {
+    namespace {
+        constexpr std::uint32_t UNSEEN = 0xFFFFFFFF;
+    }
+
+    const char* status_name(const AnytimeResult::Status status) {
+        switch (status) {
+            case AnytimeResult::Status::Found: return "found";
+            case AnytimeResult::Status::Unreachable: return "unreachable";
+            case AnytimeResult::Status::OutOfBudget: return "out of budget";
+            case AnytimeResult::Status::Cancelled: return "cancelled";
+        }
+        return "unknown";
+    }
+
+    AnytimeSolver::AnytimeSolver(const Maze& maze, const std::pair<int, int>& start, const std::pair<int, int>& goal)
+        : grid_(maze), goalRow_(goal.first), goalCol_(goal.second) {
+        for (const auto& [r, c] : {start, goal})
+            if (r < 0 || r >= grid_.rows || c < 0 || c >= grid_.cols)
+                throw std::out_of_range("Search endpoint outside the maze");
+
+        source_ = grid_.index(start);
+        target_ = grid_.index(goal);
+        closest_ = source_;
+        g_.assign(grid_.cells(), UNSEEN);
+        parent_.resize(grid_.cells());
+        closed_.assign(grid_.cells(), 0);
+        g_[source_] = 0;
+        parent_[source_] = source_;
+        heap_.push_back(static_cast<std::uint64_t>(estimate(source_)) << 32 | source_);
+    }
+
+    std::uint32_t AnytimeSolver::estimate(const std::uint32_t cell) const {
+        return std::abs(static_cast<int>(cell / grid_.cols) - goalRow_) +
+               std::abs(static_cast<int>(cell % grid_.cols) - goalCol_);
+    }
+
+    PathCodec AnytimeSolver::path_to(std::uint32_t cell) const {
+        std::vector<std::pair<int, int>> cells;
+        for (;; cell = parent_[cell]) {
+            cells.push_back(grid_.cell(cell));
+            if (cell == source_) break;
+        }
+        std::ranges::reverse(cells);
+        return PathCodec(cells);
+    }
+
+    AnytimeResult AnytimeSolver::run(const SearchBudget& budget) {
+        using Status = AnytimeResult::Status;
+        AnytimeResult result;
+        const bool timed = budget.deadline != SearchBudget::Clock::time_point::max();
+        std::uint64_t slice = 0;
+
+        while (!finished_) {
+            // Entries superseded by a shorter route are skipped without counting
+            while (!heap_.empty() && closed_[static_cast<std::uint32_t>(heap_.front())]) {
+                std::ranges::pop_heap(heap_, std::greater<>());
+                heap_.pop_back();
+            }
+            if (heap_.empty()) {
+                finished_ = true;
+                break;
+            }
+            if (budget.max_expansions && slice >= budget.max_expansions) {
+                result.status = Status::OutOfBudget;
+                break;
+            }
+            if (slice % CHECK_INTERVAL == 0) {
+                if (budget.cancel && budget.cancel->load(std::memory_order_relaxed)) {
+                    result.status = Status::Cancelled;
+                    break;
+                }
+                if (timed && SearchBudget::Clock::now() >= budget.deadline) {
+                    result.status = Status::OutOfBudget;
+                    break;
+                }
+            }
+
+            std::ranges::pop_heap(heap_, std::greater<>());
+            const auto cell = static_cast<std::uint32_t>(heap_.back());
+            heap_.pop_back();
+            closed_[cell] = 1;
+            slice++;
+
+            const std::uint32_t h = estimate(cell);
+            const std::uint32_t best = estimate(closest_);
+            if (h < best || (h == best && g_[cell] < g_[closest_])) closest_ = cell;
+            if (cell == target_) {
+                finished_ = found_ = true;
+                break;
+            }
+
+            const std::uint32_t next_g = g_[cell] + 1;
+            const std::uint8_t sides = grid_.open[cell];
+            const auto relax = [&](const std::uint32_t next) {
+                if (closed_[next] || g_[next] <= next_g) return;
+                g_[next] = next_g;
+                parent_[next] = cell;
+                heap_.push_back(static_cast<std::uint64_t>(next_g + estimate(next)) << 32 | next);
+                std::ranges::push_heap(heap_, std::greater<>());
+            };
+            if (sides & OpenGrid::Up) relax(cell - grid_.cols);
+            if (sides & OpenGrid::Down) relax(cell + grid_.cols);
+            if (sides & OpenGrid::Left) relax(cell - 1);
+            if (sides & OpenGrid::Right) relax(cell + 1);
+        }
+
+        expanded_ += slice;
+        result.expanded = slice;
+        result.total_expanded = expanded_;
+        result.closest = grid_.cell(closest_);
+        result.closest_distance = estimate(closest_);
+        if (finished_) {
+            result.status = found_ ? Status::Found : Status::Unreachable;
+            result.lower_bound = found_ ? g_[target_] : UNSEEN;
+        } else {
+            result.lower_bound = static_cast<std::uint32_t>(heap_.front() >> 32);
+        }
+        result.path = path_to(found_ ? target_ : closest_);
+        return result;
+    }
+}
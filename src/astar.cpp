@@ -65,7 +65,7 @@ namespace course {
         return neighbors;
     }
 
-    std::vector<std::pair<int, int> > Astar::reconstruct_path(const std::map<std::pair<int, int>, std::pair<int, int> > &came_from, const std::pair<int, int> &current) {
+    PathCodec Astar::reconstruct_path(const std::map<std::pair<int, int>, std::pair<int, int> > &came_from, const std::pair<int, int> &current) {
         // The ordered set of resulting vertices of a path.
         std::vector<std::pair<int, int>> path;
         // The search begins at the finish
@@ -79,16 +79,20 @@ namespace course {
         path.push_back(current_node);
         std::ranges::reverse(path);
 
-        return path;
+        return PathCodec(path);
     }
 
-    std::vector<std::pair<int, int>> Astar::find_path() {
-        const auto start = maze_.get_entrance();
-        const auto goal = maze_.get_exit();
+    PathCodec Astar::find_path() {
+        return find_path(maze_.get_entrance(), maze_.get_exit());
+    }
+
+    PathCodec Astar::find_path(const std::pair<int, int>& start, const std::pair<int, int>& goal) {
+        expanded_ = 0;
 
         // Quick check: start equals goal
         if (start == goal) {
-            path_ = {start};
+            path_.clear();
+            path_.push_back(start);
             return path_;
         }
 
@@ -119,6 +123,7 @@ namespace course {
             }
 
             closed_set.insert(current.coord);
+            expanded_++;
 
             // Explore neighbors
             for (const auto& neighbor : get_neighbors(current.coord)) {
@@ -142,38 +147,44 @@ namespace course {
         }
 
         // No path found
-        return {};
+        path_.clear();
+        return path_;
     }
 
-    void Astar::print_path(const std::vector<std::pair<int, int>>& path) {
+    void Astar::print_path(const PathCodec& path) {
         if (path.empty()) {
             std::cout << "Path is empty" << std::endl;
             return;
         }
+        if (maze_.getCols() > Maze::PRINT_MAX_COLS) {
+            std::cout << "\nMaze is too wide to draw the path (over " << Maze::PRINT_MAX_COLS << " columns)\n";
+            print_path_stats(path);
+            return;
+        }
 
         const auto entrance = maze_.get_entrance();
-        const auto exit = maze_.get_exit();
         const int rows = maze_.getRows();
         const int cols = maze_.getCols();
 
         // Create display grid initialized with spaces
         std::vector<std::vector<char>> display(rows, std::vector<char>(cols, ' '));
 
-        // Mark path with directional markers
-        for (size_t i = 0; i < path.size(); i++) {
-            const auto [row, col] = path[i];
+        // Mark path with directional markers, decoding moves lazily
+        size_t i = 0;
+        for (auto it = path.begin(); it != path.end(); ++it, ++i) {
+            const auto [row, col] = *it;
 
             if (i == 0) {
                 display[row][col] = 'E'; // Entrance marker
             } else if (i == path.size() - 1) {
                 display[row][col] = 'X'; // Exit marker
-            } else if (i + 1 < path.size()) {
-                const auto [next_row, next_col] = path[i + 1];
-
-                if (next_row > row)      display[row][col] = 'v';
-                else if (next_row < row) display[row][col] = '^';
-                else if (next_col > col) display[row][col] = '>';
-                else if (next_col < col) display[row][col] = '<';
+            } else {
+                switch (path.move_at(i)) {
+                    case PathCodec::Down:  display[row][col] = 'v'; break;
+                    case PathCodec::Up:    display[row][col] = '^'; break;
+                    case PathCodec::Right: display[row][col] = '>'; break;
+                    case PathCodec::Left:  display[row][col] = '<'; break;
+                }
             }
         }
 
@@ -219,7 +230,7 @@ namespace course {
         // Print bottom border with exit marker
         std::cout << "+";
         for (int j = 0; j < cols; j++) {
-            if (exit.first == rows - 1 && exit.second == j) {
+            if (maze_.is_exit(rows - 1, j)) {
                 std::cout << " X +"; // Exit at bottom border
             } else {
                 std::cout << "---+";
@@ -231,17 +242,19 @@ namespace course {
         std::cout << "  E = Entrance\n";
         std::cout << "  X = Exit\n";
 
-        // Print path statistics
-        std::cout << "Path statistics:\n";
-        std::cout << "  Path length: " << path.size() - 1 << " steps\n";
-        std::cout << "  Total cells in path: " << path.size() << "\n\n";
+        print_path_stats(path);
     }
 
-    void Astar::print_path_at(const std::vector<std::pair<int, int>>& path) {
+    void Astar::print_path_at(const PathCodec& path) {
         if (path.empty()) {
             std::cout << "Path is empty" << std::endl;
             return;
         }
+        if (maze_.getCols() > Maze::PRINT_MAX_COLS) {
+            std::cout << "\nMaze is too wide to draw the path (over " << Maze::PRINT_MAX_COLS << " columns)\n";
+            print_path_stats(path);
+            return;
+        }
 
         const auto entrance = maze_.get_entrance();
         const auto exit = maze_.get_exit();
@@ -317,7 +330,10 @@ namespace course {
         std::cout << "  X = Exit\n";
         std::cout << "  * = Path\n\n";
 
-        // Print path statistics
+        print_path_stats(path);
+    }
+
+    void Astar::print_path_stats(const PathCodec& path) {
         std::cout << "Path statistics:\n";
         std::cout << "  Path length: " << path.size() - 1 << " steps\n";
         std::cout << "  Total cells in path: " << path.size() << "\n\n";
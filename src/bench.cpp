@@ -0,0 +1,416 @@
+//
+// Benchmark harness for maze algorithms
+//
+
+#include <bench.h>
+
+#include <algorithm>
+#include <astar.h>
+#include <atomic>
+#include <chrono>
+#include <distance.h>
+#include <generator.h>
+#include <hpa.h>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <raceserver.h>
+#include <random>
+#include <route.h>
+#include <searchcore.h>
+#include <thread>
+
+namespace course {
+    namespace {
+        // Best wall-clock time of several runs, in seconds
+        template <typename Fn>
+        double best_of(const int repeats, Fn fn) {
+            double best = std::numeric_limits<double>::max();
+            for (int i = 0; i < std::max(repeats, 1); i++) {
+                const auto start = std::chrono::steady_clock::now();
+                fn(i);
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+            }
+            return best;
+        }
+    }
+
+    namespace {
+        void build_maze(Maze& maze, const BenchOptions& options, std::ostream& out) {
+            const auto generator = GeneratorRegistry::instance().create(options.algo);
+            maze.set_sizes(options.rows, options.cols);
+            generator->generate(maze, options.seed, options.max_threads);
+            out << "Input: " << options.rows << "x" << options.cols << " " << generator->name()
+                << " maze, seed " << options.seed << "\n";
+        }
+    }
+
+    std::vector<unsigned> bench_thread_counts(const unsigned max_threads) {
+        std::vector<unsigned> counts;
+        for (unsigned t = 1; t < max_threads; t *= 2)
+            counts.push_back(t);
+        counts.push_back(std::max(max_threads, 1u));
+        return counts;
+    }
+
+    void bench_generators(const BenchOptions& options, std::ostream& out) {
+        const double cells = static_cast<double>(options.rows) * options.cols;
+        const auto& registry = GeneratorRegistry::instance();
+
+        out << "Generator benchmark: " << options.rows << "x" << options.cols
+            << ", best of " << options.repeats << "\n\n";
+        out << std::left << std::setw(14) << "algorithm" << std::right
+            << std::setw(8) << "threads" << std::setw(12) << "time(ms)"
+            << std::setw(12) << "Mcells/s" << std::setw(10) << "speedup" << "\n";
+
+        for (const auto& name : registry.names()) {
+            const auto generator = registry.create(name);
+            Maze maze;
+            maze.set_sizes(options.rows, options.cols);
+
+            // Sequential algorithms ignore the thread count, one row is enough
+            const auto counts = generator->parallel() ? bench_thread_counts(options.max_threads)
+                                                      : std::vector<unsigned>{1};
+            double base = 0.0;
+            for (const unsigned threads : counts) {
+                const double seconds = best_of(options.repeats, [&](const int run) {
+                    generator->generate(maze, options.seed + run, threads);
+                });
+                if (threads == 1) base = seconds;
+
+                out << std::left << std::setw(14) << name << std::right
+                    << std::setw(8) << threads
+                    << std::setw(12) << std::fixed << std::setprecision(2) << seconds * 1e3
+                    << std::setw(12) << std::setprecision(2) << cells / seconds / 1e6
+                    << std::setw(9) << std::setprecision(2) << base / seconds << "x"
+                    << (generator->parallel() ? "" : "  (sequential)") << "\n";
+            }
+        }
+        out << "\n";
+    }
+
+    void bench_eller(const BenchOptions& options, std::ostream& out) {
+        const auto& registry = GeneratorRegistry::instance();
+        const auto scalar = registry.create("eller_scalar");
+        const auto kernel = registry.create("eller");
+
+        out << "Eller benchmark: " << options.rows << " rows, seed " << options.seed
+            << ", best of " << options.repeats << "\n\n";
+        out << std::right << std::setw(8) << "cols" << std::setw(14) << "scalar(ms)" << std::setw(14) << "kernel(ms)"
+            << std::setw(12) << "Mcells/s" << std::setw(10) << "speedup" << std::setw(11) << "identical" << "\n";
+
+        // The scalar path is quadratic in the width: powers of two from 64 below --cols, then --cols
+        std::vector<int> widths;
+        for (int cols = 64; cols < options.cols; cols *= 2) widths.push_back(cols);
+        widths.push_back(options.cols);
+
+        for (const int cols : widths) {
+            Maze reference, fast;
+            reference.set_sizes(options.rows, cols);
+            fast.set_sizes(options.rows, cols);
+            const double scalarSeconds = best_of(options.repeats, [&](int) {
+                scalar->generate(reference, options.seed, 1);
+            });
+            const double kernelSeconds = best_of(options.repeats, [&](int) {
+                kernel->generate(fast, options.seed, 1);
+            });
+            const bool identical = reference.content_hash() == fast.content_hash();
+
+            out << std::setw(8) << cols << std::fixed << std::setprecision(2)
+                << std::setw(14) << scalarSeconds * 1e3 << std::setw(14) << kernelSeconds * 1e3
+                << std::setw(12) << static_cast<double>(options.rows) * cols / kernelSeconds / 1e6
+                << std::setw(9) << scalarSeconds / kernelSeconds << "x"
+                << std::setw(11) << (identical ? "yes" : "NO") << "\n";
+        }
+        out << "\n";
+    }
+
+    void bench_distances(const BenchOptions& options, std::ostream& out) {
+        const double cells = static_cast<double>(options.rows) * options.cols;
+        Maze maze;
+        out << "Distance field benchmark, best of " << options.repeats << "\n";
+        build_maze(maze, options, out);
+        out << "\n" << std::right << std::setw(8) << "threads" << std::setw(12) << "time(ms)"
+            << std::setw(12) << "Mcells/s" << std::setw(10) << "speedup"
+            << std::setw(10) << "levels" << std::setw(12) << "wide lvls" << "\n";
+
+        double base = 0.0;
+        for (const unsigned threads : bench_thread_counts(options.max_threads)) {
+            DistanceField field;
+            const double seconds = best_of(options.repeats, [&](int) {
+                field = DistanceField::compute(maze, maze.get_exit(), threads);
+            });
+            if (threads == 1) base = seconds;
+
+            out << std::setw(8) << threads
+                << std::setw(12) << std::fixed << std::setprecision(2) << seconds * 1e3
+                << std::setw(12) << cells / seconds / 1e6
+                << std::setw(9) << base / seconds << "x"
+                << std::setw(10) << field.stats().levels
+                << std::setw(12) << field.stats().parallel_levels << "\n";
+        }
+        out << "\n";
+    }
+
+    void bench_race_server(const BenchOptions& options, std::ostream& out) {
+        Maze maze;
+        out << "Race server benchmark: " << options.sessions << " sessions, "
+            << options.moves << " random moves\n";
+        build_maze(maze, options, out);
+
+        RaceServer server(maze);
+        std::vector<RaceServer::SessionId> ids(std::max(options.sessions, 1));
+        for (auto& id : ids)
+            id = server.create_session();
+
+        out << "\n" << std::right << std::setw(8) << "threads" << std::setw(12) << "time(ms)"
+            << std::setw(12) << "Kmoves/s" << std::setw(10) << "speedup"
+            << std::setw(10) << "finished" << "\n";
+
+        double base = 0.0;
+        for (const unsigned threads : bench_thread_counts(options.max_threads)) {
+            std::atomic<int> finished{0};
+            const auto start = std::chrono::steady_clock::now();
+
+            // Each client drives the sessions with index = client (mod threads), so
+            // session locks are uncontended and only the shard lookups are shared
+            std::vector<std::thread> clients;
+            for (unsigned t = 0; t < threads; t++) {
+                clients.emplace_back([&, t] {
+                    std::mt19937_64 rng(options.seed + t);
+                    const int share = options.moves / static_cast<int>(threads);
+                    const size_t slots = t < ids.size() ? (ids.size() - t + threads - 1) / threads : 0;
+                    for (int i = 0; i < share && slots > 0; i++) {
+                        auto& id = ids[t + rng() % slots * threads];
+                        const auto direction = static_cast<RaceServer::Direction>(rng() & 3);
+                        if (server.move(id, direction) == RaceServer::MoveResult::Finished) {
+                            // Replace finished races so the load stays constant
+                            server.close_session(id);
+                            id = server.create_session();
+                            finished++;
+                        }
+                    }
+                });
+            }
+            for (auto& client : clients)
+                client.join();
+
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            const double seconds = elapsed.count();
+            if (threads == 1) base = seconds;
+
+            out << std::setw(8) << threads
+                << std::setw(12) << std::fixed << std::setprecision(2) << seconds * 1e3
+                << std::setw(12) << options.moves / seconds / 1e3
+                << std::setw(9) << base / seconds << "x"
+                << std::setw(10) << finished.load() << "\n";
+        }
+        out << "Sessions open: " << server.session_count() << "\n\n";
+    }
+
+    void bench_hpa(const BenchOptions& options, std::ostream& out) {
+        Maze maze;
+        out << "HPA* benchmark: cluster " << options.cluster << ", " << options.queries
+            << " random queries\n";
+        build_maze(maze, options, out);
+
+        out << "\n" << std::right << std::setw(8) << "threads" << std::setw(14) << "preproc(ms)"
+            << std::setw(10) << "speedup" << std::setw(10) << "nodes" << std::setw(10) << "edges" << "\n";
+        double base = 0.0;
+        for (const unsigned threads : bench_thread_counts(options.max_threads)) {
+            std::unique_ptr<HpaGraph> graph;
+            const double seconds = best_of(options.repeats, [&](int) {
+                graph = std::make_unique<HpaGraph>(maze, options.cluster, threads);
+            });
+            if (threads == 1) base = seconds;
+            out << std::setw(8) << threads
+                << std::setw(14) << std::fixed << std::setprecision(2) << seconds * 1e3
+                << std::setw(9) << base / seconds << "x"
+                << std::setw(10) << graph->build_stats().nodes
+                << std::setw(10) << graph->build_stats().edges << "\n";
+        }
+
+        const HpaGraph graph(maze, options.cluster, options.max_threads);
+        Astar astar(maze);
+        std::mt19937_64 rng(options.seed);
+        std::uniform_int_distribution<int> row(0, options.rows - 1), col(0, options.cols - 1);
+
+        double hpa_seconds = 0.0, flat_seconds = 0.0;
+        std::uint64_t hpa_abstract = 0, hpa_cells = 0, flat_expanded = 0, length = 0;
+        for (int q = 0; q < options.queries; q++) {
+            const std::pair start{row(rng), col(rng)};
+            const std::pair goal{row(rng), col(rng)};
+
+            HpaGraph::QueryStats stats;
+            PathCodec hierarchical;
+            hpa_seconds += best_of(1, [&](int) { hierarchical = graph.find_path(start, goal, &stats); });
+            hpa_abstract += stats.abstract_expanded;
+            hpa_cells += stats.cells_expanded;
+
+            PathCodec flat;
+            flat_seconds += best_of(1, [&](int) { flat = astar.find_path(start, goal); });
+            flat_expanded += astar.get_expanded();
+            length += flat.size();
+
+            if (hierarchical.size() != flat.size()) {
+                out << "Warning: HPA* path length differs from A* for query " << q << "\n";
+            }
+        }
+
+        const double queries = std::max(options.queries, 1);
+        out << "\nAverage path: " << std::setprecision(0) << length / queries << " cells\n";
+        out << std::left << std::setw(10) << "solver" << std::right << std::setw(14) << "query(ms)"
+            << std::setw(16) << "abstract nodes" << std::setw(14) << "cells" << "\n";
+        out << std::left << std::setw(10) << "hpa*" << std::right
+            << std::setw(14) << std::setprecision(3) << hpa_seconds * 1e3 / queries
+            << std::setw(16) << std::setprecision(0) << hpa_abstract / queries
+            << std::setw(14) << hpa_cells / queries << "\n";
+        out << std::left << std::setw(10) << "a*" << std::right
+            << std::setw(14) << std::setprecision(3) << flat_seconds * 1e3 / queries
+            << std::setw(16) << "-"
+            << std::setw(14) << std::setprecision(0) << flat_expanded / queries << "\n\n";
+    }
+
+    void bench_solvers(const BenchOptions& options, std::ostream& out) {
+        Maze maze;
+        out << "Solver benchmark: " << options.queries << " random queries\n";
+        build_maze(maze, options, out);
+
+        std::mt19937_64 rng(options.seed);
+        std::uniform_int_distribution<int> row(0, options.rows - 1), col(0, options.cols - 1);
+        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries;
+        for (int q = 0; q < options.queries; q++)
+            queries.push_back({{row(rng), col(rng)}, {row(rng), col(rng)}});
+
+        out << "\n" << std::left << std::setw(14) << "solver" << std::right << std::setw(14) << "query(ms)"
+            << std::setw(12) << "expanded" << std::setw(12) << "Mcells/s" << std::setw(12) << "avg cost" << "\n";
+        const double count = static_cast<double>(queries.size());
+        auto report = [&](const std::string& name, const double seconds, const double expanded, const double cost) {
+            out << std::left << std::setw(14) << name << std::right << std::fixed
+                << std::setw(14) << std::setprecision(3) << seconds * 1e3 / count
+                << std::setw(12) << std::setprecision(0) << expanded / count
+                << std::setw(12) << std::setprecision(2) << expanded / seconds / 1e6
+                << std::setw(12) << std::setprecision(1) << cost / count << "\n";
+        };
+
+        // Reference: map-based A* with double costs
+        Astar astar(maze);
+        double expanded = 0.0, cost = 0.0;
+        const double classic = best_of(options.repeats, [&](const int run) {
+            for (const auto& [start, goal] : queries) {
+                const auto path = astar.find_path(start, goal);
+                if (run == 0) {
+                    expanded += static_cast<double>(astar.get_expanded());
+                    cost += static_cast<double>(path.size()) - 1;
+                }
+            }
+        });
+        report("classic", classic, expanded, cost);
+
+        PolicySolver solver(maze, options.seed);
+        for (const auto& name : PolicySolver::names()) {
+            expanded = cost = 0.0;
+            const double seconds = best_of(options.repeats, [&](const int run) {
+                for (const auto& [start, goal] : queries) {
+                    const auto result = solver.solve(name, start, goal);
+                    if (run == 0) {
+                        expanded += static_cast<double>(result.expanded);
+                        cost += static_cast<double>(result.cost);
+                    }
+                }
+            });
+            report(name, seconds, expanded, cost);
+        }
+        out << "\n";
+    }
+
+    void bench_alt(const BenchOptions& options, std::ostream& out) {
+        Maze maze;
+        out << "ALT benchmark: " << options.landmarks << " landmarks, " << options.queries
+            << " random queries\n";
+        build_maze(maze, options, out);
+
+        std::mt19937_64 rng(options.seed);
+        std::uniform_int_distribution<int> row(0, options.rows - 1), col(0, options.cols - 1);
+        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries;
+        for (int q = 0; q < options.queries; q++)
+            queries.push_back({{row(rng), col(rng)}, {row(rng), col(rng)}});
+
+        PolicySolver solver(maze);
+        const double count = static_cast<double>(queries.size());
+        auto run_queries = [&](const std::string& name, double& seconds, double& expanded) {
+            expanded = 0.0;
+            seconds = best_of(options.repeats, [&](const int run) {
+                for (const auto& [start, goal] : queries) {
+                    const auto result = solver.solve(name, start, goal);
+                    if (run == 0) expanded += static_cast<double>(result.expanded);
+                }
+            });
+        };
+
+        double astar_seconds, astar_expanded;
+        run_queries("astar", astar_seconds, astar_expanded);
+
+        out << "\n" << std::left << std::setw(11) << "selection" << std::right << std::setw(8) << "threads"
+            << std::setw(14) << "preproc(ms)" << std::setw(10) << "speedup" << std::setw(10) << "KiB"
+            << std::setw(12) << "query(ms)" << std::setw(12) << "expanded" << std::setw(10) << "vs A*" << "\n";
+        out << std::left << std::setw(11) << "(manhattan)" << std::right << std::setw(8) << "-"
+            << std::setw(14) << "-" << std::setw(10) << "-" << std::setw(10) << "-" << std::fixed
+            << std::setw(12) << std::setprecision(3) << astar_seconds * 1e3 / count
+            << std::setw(12) << std::setprecision(0) << astar_expanded / count
+            << std::setw(9) << std::setprecision(2) << 1.0 << "x\n";
+
+        for (const auto selection : {Landmarks::Selection::Farthest, Landmarks::Selection::Perimeter}) {
+            const char* name = selection == Landmarks::Selection::Farthest ? "farthest" : "perimeter";
+            double base = 0.0;
+            for (const unsigned threads : bench_thread_counts(options.max_threads)) {
+                const double preprocess = best_of(options.repeats, [&](int) {
+                    solver.use_landmarks(options.landmarks, threads, selection);
+                });
+                if (threads == 1) base = preprocess;
+
+                double seconds, expanded;
+                run_queries("alt", seconds, expanded);
+                out << std::left << std::setw(11) << name << std::right << std::setw(8) << threads
+                    << std::setw(14) << std::setprecision(2) << preprocess * 1e3
+                    << std::setw(9) << base / preprocess << "x"
+                    << std::setw(10) << std::setprecision(0) << solver.landmarks()->stats().bytes / 1024.0
+                    << std::setw(12) << std::setprecision(3) << seconds * 1e3 / count
+                    << std::setw(12) << std::setprecision(0) << expanded / count
+                    << std::setw(9) << std::setprecision(2) << astar_expanded / std::max(expanded, 1.0) << "x\n";
+            }
+        }
+        out << "\n";
+    }
+
+    void bench_route(const BenchOptions& options, std::ostream& out) {
+        Maze maze;
+        out << "Route benchmark: " << options.waypoints << " random waypoints\n";
+        build_maze(maze, options, out);
+
+        std::mt19937_64 rng(options.seed);
+        std::uniform_int_distribution<int> row(0, options.rows - 1), col(0, options.cols - 1);
+        std::vector<std::pair<int, int>> points = {maze.get_entrance()};
+        for (int w = 0; w < options.waypoints; w++)
+            points.emplace_back(row(rng), col(rng));
+        points.push_back(maze.get_exit());
+
+        out << "\n" << std::left << std::setw(10) << "matrix" << std::right << std::setw(8) << "threads"
+            << std::setw(12) << "time(ms)" << std::setw(10) << "speedup" << "\n";
+        double base = 0.0;
+        for (const unsigned threads : bench_thread_counts(options.max_threads)) {
+            const double seconds = best_of(options.repeats, [&](int) { distance_matrix(maze, points, threads); });
+            if (threads == 1) base = seconds;
+            out << std::left << std::setw(10) << points.size() << std::right << std::setw(8) << threads << std::fixed
+                << std::setw(12) << std::setprecision(2) << seconds * 1e3
+                << std::setw(9) << base / seconds << "x\n";
+        }
+
+        const std::vector<std::pair<int, int>> waypoints(points.begin() + 1, points.end() - 1);
+        const auto route = plan_route(maze, waypoints, options.max_threads);
+        out << "\nOrder: " << (route.exact ? "exact" : "2-opt") << ", " << route.length << " steps, "
+            << std::setprecision(3) << route.order_seconds * 1e3 << " ms\n\n";
+    }
+}
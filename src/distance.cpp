@@ -0,0 +1,361 @@
+//
+// Whole-maze distance field from one or more source cells
+//
+
+#include <distance.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <searchcore.h>
+#include <stdexcept>
+#include <threadpool.h>
+
+namespace course {
+    namespace {
+        constexpr char MAGIC[4] = {'M', 'Z', 'D', '2'};
+        // Same layout without the maze hash; still readable
+        constexpr char MAGIC_V1[4] = {'M', 'Z', 'D', '1'};
+        // Levels narrower than this are cheaper to expand on one thread
+        constexpr size_t PARALLEL_FRONTIER = 1024;
+
+        struct FieldHeader {
+            std::int32_t rows = 0, cols = 0;
+            std::pair<int, int> source;
+            std::uint64_t maze_hash = 0;
+            int width = 0;
+            /// Offset of the first distance
+            size_t size = 0;
+        };
+
+        // Magic, rows, cols, source row and column, maze hash (v2 only), value width
+        bool read_field_header(std::istream& file, FieldHeader& header) {
+            char magic[4];
+            std::int32_t values[4];
+            file.read(magic, sizeof(magic));
+            file.read(reinterpret_cast<char*>(values), sizeof(values));
+            const bool v1 = file && std::memcmp(magic, MAGIC_V1, sizeof(MAGIC_V1)) == 0;
+            if (!file || (!v1 && std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)) return false;
+            if (!v1) file.read(reinterpret_cast<char*>(&header.maze_hash), sizeof(header.maze_hash));
+
+            header.rows = values[0];
+            header.cols = values[1];
+            header.source = {values[2], values[3]};
+            header.width = file.get();
+            header.size = sizeof(magic) + sizeof(values) + (v1 ? 0 : sizeof(header.maze_hash)) + 1;
+            return file && header.rows >= 0 && header.cols >= 0 && header.width >= 1 && header.width <= 4;
+        }
+    }
+
+    DistanceField DistanceField::compute(const Maze& maze, const std::pair<int, int>& source, const unsigned threads) {
+        return compute(maze, std::vector{source}, threads);
+    }
+
+    DistanceField DistanceField::compute(const Maze& maze, const std::vector<std::pair<int, int>>& sources,
+                                         const unsigned threads) {
+        if (sources.empty())
+            throw std::invalid_argument("Distance field needs at least one source");
+
+        DistanceField field;
+        field.rows_ = maze.getRows();
+        field.cols_ = maze.getCols();
+        field.source_ = sources.front();
+        field.sources_ = sources;
+
+        const int rows = field.rows_;
+        const int cols = field.cols_;
+        const size_t cells = static_cast<size_t>(rows) * cols;
+        field.dist_.assign(cells, UNREACHABLE);
+        if (cells == 0) return field;
+        for (const auto& [r, c] : sources)
+            if (r < 0 || r >= rows || c < 0 || c >= cols)
+                throw std::out_of_range("Distance source outside the maze");
+
+        const bool labelled = sources.size() > 1;
+        if (labelled) field.nearest_.assign(cells, 0);
+        auto& nearest = field.nearest_;
+
+        auto& dist = field.dist_;
+        ThreadPool pool(threads);
+        const OpenGrid grid(maze, &pool);
+        const auto& open = grid.open;
+
+        // Visited bitset; fetch_or decides which thread claims a cell
+        std::vector<std::atomic<std::uint64_t>> visited((cells + 63) / 64);
+        auto claim = [&visited](const size_t cell) {
+            const std::uint64_t mask = std::uint64_t{1} << (cell & 63);
+            if (visited[cell >> 6].load(std::memory_order_relaxed) & mask) return false;
+            return !(visited[cell >> 6].fetch_or(mask, std::memory_order_relaxed) & mask);
+        };
+
+        auto expand = [&](const size_t cell, const std::uint32_t level, std::vector<size_t>& next) {
+            const std::uint8_t sides = open[cell];
+            auto visit = [&](const size_t neighbor) {
+                if (claim(neighbor)) {
+                    dist[neighbor] = level + 1;
+                    if (labelled) nearest[neighbor] = nearest[cell];
+                    next.push_back(neighbor);
+                }
+            };
+            if (sides & OpenGrid::Up) visit(cell - cols);
+            if (sides & OpenGrid::Down) visit(cell + cols);
+            if (sides & OpenGrid::Left) visit(cell - 1);
+            if (sides & OpenGrid::Right) visit(cell + 1);
+        };
+
+        std::vector<std::vector<size_t>> local(pool.size());
+
+        // The first claim of a cell may come from any source at the previous level; once the
+        // level is complete each new cell takes the lowest index among its predecessors
+        auto relabel = [&](const size_t cell, const std::uint32_t level) {
+            const std::uint8_t sides = open[cell];
+            std::uint32_t best = UNREACHABLE;
+            auto consider = [&](const size_t neighbor) {
+                if (dist[neighbor] == level) best = std::min(best, nearest[neighbor]);
+            };
+            if (sides & OpenGrid::Up) consider(cell - cols);
+            if (sides & OpenGrid::Down) consider(cell + cols);
+            if (sides & OpenGrid::Left) consider(cell - 1);
+            if (sides & OpenGrid::Right) consider(cell + 1);
+            nearest[cell] = best;
+        };
+
+        std::vector<size_t> frontier;
+        for (std::uint32_t i = 0; i < sources.size(); i++) {
+            const size_t start = static_cast<size_t>(sources[i].first) * cols + sources[i].second;
+            if (!claim(start)) continue;
+            dist[start] = 0;
+            if (labelled) nearest[start] = i;
+            frontier.push_back(start);
+        }
+        std::vector<size_t> next;
+        std::uint32_t level = 0;
+        field.stats_.reached = frontier.size();
+
+        while (!frontier.empty()) {
+            next.clear();
+            if (pool.size() == 1 || frontier.size() < PARALLEL_FRONTIER) {
+                for (const size_t cell : frontier)
+                    expand(cell, level, next);
+                if (labelled) {
+                    for (const size_t cell : next)
+                        relabel(cell, level);
+                }
+            } else {
+                // Each thread expands one contiguous slice into its own buffer
+                const size_t slices = pool.size();
+                pool.run_on_all([&](const unsigned worker) {
+                    auto& out = local[worker];
+                    out.clear();
+                    const size_t begin = frontier.size() * worker / slices;
+                    const size_t end = frontier.size() * (worker + 1) / slices;
+                    for (size_t i = begin; i < end; i++)
+                        expand(frontier[i], level, out);
+                });
+                for (const auto& out : local)
+                    next.insert(next.end(), out.begin(), out.end());
+                if (labelled) {
+                    pool.run_on_all([&](const unsigned worker) {
+                        const size_t begin = next.size() * worker / slices;
+                        const size_t end = next.size() * (worker + 1) / slices;
+                        for (size_t i = begin; i < end; i++)
+                            relabel(next[i], level);
+                    });
+                }
+                field.stats_.parallel_levels++;
+            }
+
+            field.stats_.reached += next.size();
+            field.stats_.peak_frontier = std::max(field.stats_.peak_frontier, frontier.size());
+            frontier.swap(next);
+            level++;
+        }
+        field.stats_.levels = level;
+        return field;
+    }
+
+    std::uint32_t DistanceField::max_distance() const {
+        std::uint32_t result = 0;
+        for (const auto d : dist_)
+            if (d != UNREACHABLE) result = std::max(result, d);
+        return result;
+    }
+
+    void DistanceField::to_file(const std::string& filename, const std::uint64_t maze_hash) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file for writing: " + filename);
+        }
+
+        // Smallest width whose all-ones value can stand for UNREACHABLE
+        const std::uint32_t maximum = max_distance();
+        std::uint8_t width = 1;
+        while (width < 4 && maximum >= (std::uint32_t{1} << (8 * width)) - 1) width++;
+
+        const std::int32_t header[4] = {rows_, cols_, source_.first, source_.second};
+        file.write(MAGIC, sizeof(MAGIC));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&maze_hash), sizeof(maze_hash));
+        file.put(static_cast<char>(width));
+
+        const std::uint32_t unreachable = width == 4 ? UNREACHABLE : (std::uint32_t{1} << (8 * width)) - 1;
+        std::vector<char> buffer;
+        buffer.reserve(static_cast<size_t>(cols_) * width);
+        for (int i = 0; i < rows_; i++) {
+            buffer.clear();
+            for (int j = 0; j < cols_; j++) {
+                const std::uint32_t d = at(i, j) == UNREACHABLE ? unreachable : at(i, j);
+                for (int b = 0; b < width; b++)
+                    buffer.push_back(static_cast<char>(d >> (8 * b) & 0xFF));
+            }
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+
+        file.close();
+    }
+
+    void DistanceField::from_file(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        FieldHeader header;
+        if (!read_field_header(file, header)) {
+            throw std::invalid_argument("Not a distance field file: " + filename);
+        }
+
+        const int width = header.width;
+        rows_ = header.rows;
+        cols_ = header.cols;
+        source_ = header.source;
+        sources_ = {source_};
+        nearest_.clear();
+        stats_ = Stats();
+
+        const std::uint32_t unreachable = width == 4 ? UNREACHABLE : (std::uint32_t{1} << (8 * width)) - 1;
+        std::vector<unsigned char> buffer(static_cast<size_t>(cols_) * width);
+        dist_.assign(static_cast<size_t>(rows_) * cols_, UNREACHABLE);
+        for (int i = 0; i < rows_; i++) {
+            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            if (!file) {
+                throw std::runtime_error("Unexpected end of distance field file");
+            }
+            for (int j = 0; j < cols_; j++) {
+                std::uint32_t d = 0;
+                for (int b = 0; b < width; b++)
+                    d |= static_cast<std::uint32_t>(buffer[static_cast<size_t>(j) * width + b]) << (8 * b);
+                dist_[static_cast<size_t>(i) * cols_ + j] = d == unreachable ? UNREACHABLE : d;
+                if (d != unreachable) stats_.reached++;
+            }
+        }
+    }
+
+    bool DistanceField::read_header(const std::string& filename, int& rows, int& cols, std::pair<int, int>& source,
+                                    std::uint64_t& maze_hash) {
+        std::ifstream file(filename, std::ios::binary);
+        FieldHeader header;
+        if (!read_field_header(file, header)) return false;
+
+        rows = header.rows;
+        cols = header.cols;
+        source = header.source;
+        maze_hash = header.maze_hash;
+        return true;
+    }
+
+    std::vector<std::uint32_t> DistanceField::read_cells(const std::string& filename,
+                                                         const std::vector<std::pair<int, int>>& cells) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        FieldHeader header;
+        if (!read_field_header(file, header)) {
+            throw std::invalid_argument("Not a distance field file: " + filename);
+        }
+        const int width = header.width;
+
+        const std::uint32_t unreachable = width == 4 ? UNREACHABLE : (std::uint32_t{1} << (8 * width)) - 1;
+        std::vector<std::uint32_t> result;
+        result.reserve(cells.size());
+        for (const auto& [row, col] : cells) {
+            if (row < 0 || row >= header.rows || col < 0 || col >= header.cols) {
+                result.push_back(UNREACHABLE);
+                continue;
+            }
+
+            unsigned char bytes[4] = {};
+            file.seekg(static_cast<std::streamoff>(header.size + (static_cast<size_t>(row) * header.cols + col) * width));
+            file.read(reinterpret_cast<char*>(bytes), width);
+            if (!file) {
+                throw std::runtime_error("Unexpected end of distance field file");
+            }
+
+            std::uint32_t d = 0;
+            for (int b = 0; b < width; b++)
+                d |= static_cast<std::uint32_t>(bytes[b]) << (8 * b);
+            result.push_back(d == unreachable ? UNREACHABLE : d);
+        }
+        return result;
+    }
+
+    // Downhill from cell, preferring neighbours labelled with the same source so the
+    // walk ends at the source it was measured to
+    PathCodec DistanceField::path_from(const Maze& maze, const std::pair<int, int>& cell) const {
+        PathCodec path;
+        if (cell.first < 0 || cell.first >= rows_ || cell.second < 0 || cell.second >= cols_ ||
+            at(cell.first, cell.second) == UNREACHABLE)
+            return path;
+
+        const auto& vWalls = maze.get_v_walls();
+        const auto& hWalls = maze.get_h_walls();
+        const std::uint32_t target = nearest(cell.first, cell.second);
+        auto [r, c] = cell;
+        path.push_back(cell);
+        for (std::uint32_t d = at(r, c); d > 0; d--) {
+            std::pair<int, int> step{-1, -1};
+            const auto consider = [&](const int nr, const int nc, const bool open) {
+                if (!open || at(nr, nc) != d - 1) return;
+                if (step.first < 0 || (nearest(nr, nc) == target && nearest(step.first, step.second) != target))
+                    step = {nr, nc};
+            };
+            consider(r - 1, c, r > 0 && !hWalls(r - 1, c));
+            consider(r + 1, c, r < rows_ - 1 && !hWalls(r, c));
+            consider(r, c - 1, c > 0 && !vWalls(r, c - 1));
+            consider(r, c + 1, c < cols_ - 1 && !vWalls(r, c));
+            if (step.first < 0)
+                throw std::logic_error("Distance field does not match the maze");
+            std::tie(r, c) = step;
+            path.push_back(step);
+        }
+        return path;
+    }
+
+    std::pair<std::pair<int, int>, std::pair<int, int>> farthest_border_pair(const Maze& maze, const unsigned threads) {
+        const int rows = maze.getRows();
+        const int cols = maze.getCols();
+        // Ties go to the first border cell clockwise from (0, 0)
+        const auto farthest = [&](const DistanceField& field) {
+            std::pair<int, int> best = field.get_source();
+            std::uint32_t bestDistance = 0;
+            const auto consider = [&](const int r, const int c) {
+                const std::uint32_t d = field.at(r, c);
+                if (d != DistanceField::UNREACHABLE && d > bestDistance) {
+                    bestDistance = d;
+                    best = {r, c};
+                }
+            };
+            for (int c = 0; c < cols; c++) consider(0, c);
+            for (int r = 1; r < rows; r++) consider(r, cols - 1);
+            for (int c = cols - 2; c >= 0 && rows > 1; c--) consider(rows - 1, c);
+            for (int r = rows - 2; r > 0 && cols > 1; r--) consider(r, 0);
+            return best;
+        };
+
+        const auto first = farthest(DistanceField::compute(maze, {0, 0}, threads));
+        return {first, farthest(DistanceField::compute(maze, first, threads))};
+    }
+}
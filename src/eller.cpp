@@ -0,0 +1,187 @@
+//
+// Eller's algorithm on 64-bit words: seeded row decisions and the bit-parallel row kernel
+//
+
+#include <eller.h>
+
+#include <algorithm>
+#include <bit>
+#include <splitmix.h>
+
+namespace course {
+    namespace {
+        constexpr std::uint64_t bit(const int col) { return std::uint64_t{1} << (col & 63); }
+
+        // Columns [0, end) of word w
+        std::uint64_t columns_below(const int w, const int end) {
+            const int bits = std::clamp(end - w * 64, 0, 64);
+            return bits == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << bits) - 1;
+        }
+    }
+
+    // SplitMix64 seeded per row: right words first, then down words
+    void EllerRowBits::draw(const std::uint64_t seed, const int row, const int cols) {
+        const size_t words = (static_cast<size_t>(cols) + 63) / 64;
+        right.resize(words);
+        down.resize(words);
+
+        std::uint64_t state = seed ^ (static_cast<std::uint64_t>(row) + 1) * 0xD1B54A32D192ED03ULL;
+        for (auto& word : right) word = splitmix64(state);
+        for (auto& word : down) word = splitmix64(state);
+    }
+
+    EllerKernel::EllerKernel(const MazeShape& shape, const std::uint64_t seed)
+        : shape_(shape), seed_(seed), words_((shape.cols + 63) / 64),
+          set_(shape.cols, 0), parent_(shape.cols + 1), count_(shape.cols + 1),
+          right_(words_), down_(words_) {}
+
+    std::uint32_t EllerKernel::find(std::uint32_t x) {
+        while (parent_[x] != x) {
+            parent_[x] = parent_[parent_[x]];
+            x = parent_[x];
+        }
+        return x;
+    }
+
+    // Cells without a set get fresh ones after the carried sets 1..k
+    void EllerKernel::start_row() {
+        std::uint32_t sets = 0;
+        for (const std::uint32_t set : set_)
+            sets = std::max(sets, set);
+        for (auto& set : set_)
+            if (set == 0) set = ++sets;
+        for (std::uint32_t id = 1; id <= sets; id++)
+            parent_[id] = id;
+        bits_.draw(seed_, row_, shape_.cols);
+    }
+
+    // Clear proposal bits are passages unless both cells already share a set
+    void EllerKernel::add_right_walls(const int row) {
+        const int cols = shape_.cols;
+        std::ranges::copy(bits_.right, right_.begin());
+
+        // An entrance in the last column opens the wall to its left without joining sets
+        const int forced = row == shape_.entrance.first && shape_.entrance.second == cols - 1 ? cols - 2 : -1;
+
+        for (int w = 0; w < words_; w++) {
+            std::uint64_t passages = ~right_[w] & columns_below(w, cols - 1);
+            if (forced >= 0 && forced >> 6 == w) passages &= ~bit(forced);
+            for (; passages; passages &= passages - 1) {
+                const int c = w * 64 + std::countr_zero(passages);
+                const std::uint32_t a = find(set_[c]);
+                const std::uint32_t b = find(set_[c + 1]);
+                if (a == b) {
+                    right_[w] |= bit(c);
+                } else {
+                    parent_[b] = a;
+                }
+            }
+        }
+        if (forced >= 0) right_[forced >> 6] &= ~bit(forced);
+        right_[(cols - 1) >> 6] |= bit(cols - 1);
+    }
+
+    // Single-cell sets never get a bottom wall, and every set keeps at least one passage down
+    void EllerKernel::add_bottom_walls(const int row) {
+        const int cols = shape_.cols;
+        // Open below the entrance and above the exit whatever the sets say
+        std::vector<int> exempt;
+        if (row == shape_.exit.first - 1 && shape_.exit.first != 0) exempt.push_back(shape_.exit.second);
+        if (row == shape_.entrance.first && shape_.entrance.first != shape_.rows - 1)
+            exempt.push_back(shape_.entrance.second);
+
+        std::fill_n(count_.begin(), cols + 1, 0);
+        for (int c = 0; c < cols; c++) {
+            set_[c] = find(set_[c]);
+            count_[set_[c]]++;
+        }
+
+        for (int w = 0; w < words_; w++) {
+            std::uint64_t singles = 0;
+            const int end = std::min(cols, (w + 1) * 64);
+            for (int c = w * 64; c < end; c++)
+                singles |= static_cast<std::uint64_t>(count_[set_[c]] == 1) << (c & 63);
+            down_[w] = bits_.down[w] & ~singles;
+        }
+        for (const int c : exempt)
+            down_[c >> 6] &= ~bit(c);
+
+        // Flag sets that already have a passage, then open the leftmost cell of the others
+        std::fill_n(count_.begin(), cols + 1, 0);
+        for (int w = 0; w < words_; w++) {
+            for (std::uint64_t open = ~down_[w] & columns_below(w, cols); open; open &= open - 1)
+                count_[set_[w * 64 + std::countr_zero(open)]] = 1;
+        }
+        for (int c = 0; c < cols; c++) {
+            if (!count_[set_[c]]) {
+                down_[c >> 6] &= ~bit(c);
+                count_[set_[c]] = 1;
+            }
+        }
+    }
+
+    // Last row: join every pair of different sets and close the bottom except at the exit
+    void EllerKernel::close_last_row() {
+        const int cols = shape_.cols;
+        const bool exitBelow = shape_.exit.first == shape_.rows - 1;
+        for (int c = 0; c + 1 < cols; c++) {
+            const std::uint32_t a = find(set_[c]);
+            const std::uint32_t b = find(set_[c + 1]);
+            if (a != b || (exitBelow && c == shape_.exit.second)) {
+                right_[c >> 6] &= ~bit(c);
+                parent_[b] = a;
+            }
+        }
+
+        std::ranges::fill(down_, ~std::uint64_t{0});
+        if (exitBelow) down_[shape_.exit.second >> 6] &= ~bit(shape_.exit.second);
+    }
+
+    // Cells walled below start new sets; the rest keep theirs, renumbered 1..k
+    void EllerKernel::carry_sets() {
+        const int cols = shape_.cols;
+        std::fill_n(count_.begin(), cols + 1, 0);
+        std::uint32_t sets = 0;
+        for (int c = 0; c < cols; c++) {
+            if (down_[c >> 6] & bit(c)) {
+                set_[c] = 0;
+            } else {
+                std::uint32_t& id = count_[set_[c]];
+                if (id == 0) id = ++sets;
+                set_[c] = id;
+            }
+        }
+    }
+
+    void EllerKernel::emit(const int row, bool* vWalls, bool* hWalls) const {
+        for (int c = 0; c < shape_.cols; c++) {
+            vWalls[c] = right_[c >> 6] & bit(c);
+            hWalls[c] = down_[c >> 6] & bit(c);
+        }
+
+        // Same openings as Maze::open_entrance_exit
+        for (const auto& [endRow, col] : {shape_.entrance, shape_.exit}) {
+            if (endRow != row) continue;
+            if (row == shape_.rows - 1) {
+                hWalls[col] = false;
+            } else if (col == shape_.cols - 1 && row > 0) {
+                vWalls[shape_.cols - 1] = false;
+            }
+        }
+    }
+
+    void EllerKernel::next_row(bool* vWalls, bool* hWalls) {
+        const int row = row_;
+        start_row();
+        add_right_walls(row);
+        if (row < shape_.rows - 1) {
+            add_bottom_walls(row);
+            emit(row, vWalls, hWalls);
+            carry_sets();
+        } else {
+            close_last_row();
+            emit(row, vWalls, hWalls);
+        }
+        row_++;
+    }
+}
@@ -0,0 +1,389 @@
+//
+// Maze generators: registry and algorithm implementations
+//
+
+#include <generator.h>
+
+#include <algorithm>
+#include <numeric>
+#include <splitmix.h>
+#include <stdexcept>
+#include <thread>
+
+namespace course {
+    namespace {
+        // Small and fast PRNG, cheap enough to seed once per row
+        struct SplitMix64 {
+            using result_type = std::uint64_t;
+            std::uint64_t state;
+
+            explicit SplitMix64(const std::uint64_t seed) : state(seed) {}
+
+            static constexpr result_type min() { return 0; }
+            static constexpr result_type max() { return ~result_type{0}; }
+
+            result_type operator()() { return splitmix64(state); }
+
+            // Uniform value in [0, bound)
+            std::uint32_t below(const std::uint32_t bound) {
+                return static_cast<std::uint32_t>(((*this)() >> 32) * bound >> 32);
+            }
+        };
+
+        // Random bits consumed one at a time from 64-bit words
+        struct BitStream {
+            SplitMix64& rng;
+            std::uint64_t word = 0;
+            int left = 0;
+
+            bool next() {
+                if (left == 0) {
+                    word = rng();
+                    left = 64;
+                }
+                const bool bit = word & 1;
+                word >>= 1;
+                left--;
+                return bit;
+            }
+        };
+
+        std::uint64_t row_seed(const std::uint64_t seed, const int row) {
+            return seed ^ (static_cast<std::uint64_t>(row) + 1) * 0xD1B54A32D192ED03ULL;
+        }
+
+        // Start from a fully walled grid: every cell closed on right and bottom
+        void fill_walls(Maze& maze) {
+            auto& vWalls = maze.get_v_walls();
+            auto& hWalls = maze.get_h_walls();
+            for (int i = 0; i < maze.getRows(); i++)
+                for (int j = 0; j < maze.getCols(); j++) {
+                    vWalls(i, j) = true;
+                    hWalls(i, j) = true;
+                }
+        }
+
+        // Remove the wall between cell index a and its right or lower neighbour b
+        void carve(Maze& maze, const int a, const int b) {
+            const int cols = maze.getCols();
+            const int lo = std::min(a, b);
+            if (std::abs(a - b) == cols)
+                maze.get_h_walls()(lo / cols, lo % cols) = false;
+            else
+                maze.get_v_walls()(lo / cols, lo % cols) = false;
+        }
+
+        // Neighbour of cell in direction 0..3 (up, down, left, right), -1 outside
+        int neighbor(const int cell, const int dir, const int rows, const int cols) {
+            const int r = cell / cols;
+            const int c = cell % cols;
+            switch (dir) {
+                case 0: return r > 0 ? cell - cols : -1;
+                case 1: return r < rows - 1 ? cell + cols : -1;
+                case 2: return c > 0 ? cell - 1 : -1;
+                default: return c < cols - 1 ? cell + 1 : -1;
+            }
+        }
+
+        // Split [0, rows) into contiguous chunks, one per thread
+        template <typename Fn>
+        void for_row_chunks(const int rows, unsigned threads, Fn fn) {
+            threads = std::clamp(threads, 1u, static_cast<unsigned>(std::max(rows, 1)));
+            if (threads == 1) {
+                fn(0, rows);
+                return;
+            }
+
+            std::vector<std::thread> pool;
+            const int chunk = (rows + static_cast<int>(threads) - 1) / static_cast<int>(threads);
+            for (int begin = 0; begin < rows; begin += chunk)
+                pool.emplace_back(fn, begin, std::min(rows, begin + chunk));
+            for (auto& t : pool)
+                t.join();
+        }
+
+        // Fill every row through generate_row, rows split across threads
+        void generate_by_rows(const Generator& generator, Maze& maze, const std::uint64_t seed, const unsigned threads) {
+            const int rows = maze.getRows();
+            const int cols = maze.getCols();
+            auto& vWalls = maze.get_v_walls();
+            auto& hWalls = maze.get_h_walls();
+
+            for_row_chunks(rows, threads, [&](const int begin, const int end) {
+                for (int i = begin; i < end; i++)
+                    generator.generate_row(i, rows, cols, seed, &vWalls(i, 0), &hWalls(i, 0));
+            });
+
+            maze.clear_gen();
+            maze.open_entrance_exit();
+        }
+    }
+
+    GeneratorRegistry& GeneratorRegistry::instance() {
+        static GeneratorRegistry registry;
+        return registry;
+    }
+
+    GeneratorRegistry::GeneratorRegistry() {
+        add("eller", [] { return std::make_unique<EllerGenerator>(); });
+        add("eller_scalar", [] { return std::make_unique<EllerScalarGenerator>(); });
+        add("binary_tree", [] { return std::make_unique<BinaryTreeGenerator>(); });
+        add("sidewinder", [] { return std::make_unique<SidewinderGenerator>(); });
+        add("wilson", [] { return std::make_unique<WilsonGenerator>(); });
+        add("kruskal", [] { return std::make_unique<KruskalGenerator>(); });
+        add("backtracker", [] { return std::make_unique<BacktrackerGenerator>(); });
+    }
+
+    void GeneratorRegistry::add(const std::string& name, Factory factory) {
+        factories_[name] = std::move(factory);
+    }
+
+    std::unique_ptr<Generator> GeneratorRegistry::create(const std::string& name) const {
+        const auto it = factories_.find(name);
+        if (it == factories_.end())
+            throw std::invalid_argument("Unknown generator: " + name);
+        return it->second();
+    }
+
+    std::vector<std::string> GeneratorRegistry::names() const {
+        std::vector<std::string> result;
+        for (const auto& [name, factory] : factories_)
+            result.push_back(name);
+        return result;
+    }
+
+    void EllerGenerator::generate(Maze& maze, const std::uint64_t seed, const unsigned threads) const {
+        for (auto rows = generate_rows(maze, seed, threads); rows.next();) {}
+    }
+
+    RowStream EllerGenerator::generate_rows(Maze& maze, const std::uint64_t seed, unsigned) const {
+        maze.clear_gen();
+        EllerKernel kernel(maze.shape(), seed);
+        for (int i = 0; i < maze.getRows(); i++) {
+            kernel.next_row(&maze.get_v_walls()(i, 0), &maze.get_h_walls()(i, 0));
+            co_yield WallRow{i, maze.getCols(), &maze.get_v_walls()(i, 0), &maze.get_h_walls()(i, 0)};
+        }
+    }
+
+    RowStream EllerGenerator::stream_rows(const int rows, const int cols, const std::uint64_t seed) const {
+        EllerKernel kernel({rows, cols, {0, 0}, {rows - 1, cols - 1}, {}}, seed);
+        const auto vRow = std::make_unique<bool[]>(cols);
+        const auto hRow = std::make_unique<bool[]>(cols);
+        for (int i = 0; i < rows; i++) {
+            kernel.next_row(vRow.get(), hRow.get());
+            co_yield WallRow{i, cols, vRow.get(), hRow.get()};
+        }
+    }
+
+    void EllerScalarGenerator::generate(Maze& maze, const std::uint64_t seed, const unsigned threads) const {
+        for (auto rows = generate_rows(maze, seed, threads); rows.next();) {}
+    }
+
+    RowStream EllerScalarGenerator::generate_rows(Maze& maze, const std::uint64_t seed, unsigned) const {
+        maze.clear_gen();
+        return maze.generate_rows(seed);
+    }
+
+    void Generator::generate_row(int, int, int, std::uint64_t, bool*, bool*) const {
+        throw std::logic_error("Generator '" + name() + "' cannot produce independent rows");
+    }
+
+    RowStream Generator::generate_rows(Maze& maze, const std::uint64_t seed, const unsigned threads) const {
+        generate(maze, seed, threads);
+        for (auto rows = maze.rows(); rows.next();)
+            co_yield rows.row();
+    }
+
+    RowStream Generator::stream_rows(const int rows, const int cols, const std::uint64_t seed) const {
+        if (!row_independent())
+            throw std::invalid_argument("Generator '" + name() + "' cannot stream rows");
+
+        const auto vRow = std::make_unique<bool[]>(cols);
+        const auto hRow = std::make_unique<bool[]>(cols);
+        for (int i = 0; i < rows; i++) {
+            generate_row(i, rows, cols, seed, vRow.get(), hRow.get());
+            // Same opening as Maze::open_entrance_exit for the default exit corner
+            if (i == rows - 1) hRow[cols - 1] = false;
+            co_yield WallRow{i, cols, vRow.get(), hRow.get()};
+        }
+    }
+
+    void BinaryTreeGenerator::generate(Maze& maze, const std::uint64_t seed, const unsigned threads) const {
+        generate_by_rows(*this, maze, seed, threads);
+    }
+
+    void BinaryTreeGenerator::generate_row(const int row, const int rows, const int cols, const std::uint64_t seed,
+                                           bool* vWalls, bool* hWalls) const {
+        SplitMix64 rng(row_seed(seed, row));
+        BitStream bits{rng};
+        for (int j = 0; j < cols; j++) {
+            bool right;
+            if (row == rows - 1)
+                right = true;
+            else if (j == cols - 1)
+                right = false;
+            else
+                right = bits.next();
+
+            // The bottom-right cell is the root and keeps both walls
+            vWalls[j] = !(right && j < cols - 1);
+            hWalls[j] = right || row == rows - 1;
+        }
+    }
+
+    void SidewinderGenerator::generate(Maze& maze, const std::uint64_t seed, const unsigned threads) const {
+        generate_by_rows(*this, maze, seed, threads);
+    }
+
+    void SidewinderGenerator::generate_row(const int row, const int rows, const int cols, const std::uint64_t seed,
+                                           bool* vWalls, bool* hWalls) const {
+        SplitMix64 rng(row_seed(seed, row));
+        BitStream bits{rng};
+        for (int j = 0; j < cols; j++)
+            hWalls[j] = true;
+
+        // Last row is a single open corridor
+        if (row == rows - 1) {
+            for (int j = 0; j < cols; j++)
+                vWalls[j] = j == cols - 1;
+            return;
+        }
+
+        // Each row only touches its own walls, so rows never race
+        int run_start = 0;
+        for (int j = 0; j < cols; j++) {
+            // Close the run at the border or on a coin flip, then carve one cell down
+            if (j == cols - 1 || bits.next()) {
+                const int down = run_start + static_cast<int>(rng.below(j - run_start + 1));
+                hWalls[down] = false;
+                vWalls[j] = true;
+                run_start = j + 1;
+            } else {
+                vWalls[j] = false;
+            }
+        }
+    }
+
+    void WilsonGenerator::generate(Maze& maze, const std::uint64_t seed, unsigned) const {
+        const int rows = maze.getRows();
+        const int cols = maze.getCols();
+        const int cells = rows * cols;
+        SplitMix64 rng(seed);
+
+        fill_walls(maze);
+        std::vector<std::uint8_t> in_tree(cells, 0);
+        std::vector<std::int8_t> walk(cells, -1);
+        in_tree[rng.below(cells)] = 1;
+
+        for (int start = 0; start < cells; start++) {
+            if (in_tree[start]) continue;
+
+            // Random walk until the tree is hit; revisits overwrite the exit direction,
+            // which erases loops implicitly
+            int cell = start;
+            while (!in_tree[cell]) {
+                int next;
+                int dir;
+                do {
+                    dir = static_cast<int>(rng.below(4));
+                    next = neighbor(cell, dir, rows, cols);
+                } while (next < 0);
+                walk[cell] = static_cast<std::int8_t>(dir);
+                cell = next;
+            }
+
+            // Retrace the loop-erased walk and add it to the tree
+            cell = start;
+            while (!in_tree[cell]) {
+                const int next = neighbor(cell, walk[cell], rows, cols);
+                carve(maze, cell, next);
+                in_tree[cell] = 1;
+                cell = next;
+            }
+        }
+
+        maze.clear_gen();
+        maze.open_entrance_exit();
+    }
+
+    void KruskalGenerator::generate(Maze& maze, const std::uint64_t seed, unsigned) const {
+        const int rows = maze.getRows();
+        const int cols = maze.getCols();
+        const int cells = rows * cols;
+        SplitMix64 rng(seed);
+
+        fill_walls(maze);
+
+        // Edge e < cells joins e with its right neighbour, e >= cells joins e - cells with the one below
+        std::vector<int> edges;
+        edges.reserve(2 * static_cast<size_t>(cells));
+        for (int cell = 0; cell < cells; cell++) {
+            if (cell % cols < cols - 1) edges.push_back(cell);
+            if (cell / cols < rows - 1) edges.push_back(cells + cell);
+        }
+        for (size_t i = edges.size(); i > 1; i--)
+            std::swap(edges[i - 1], edges[rng.below(static_cast<std::uint32_t>(i))]);
+
+        std::vector<int> parent(cells);
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](int x) {
+            while (parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        };
+
+        int joined = 0;
+        for (const int edge : edges) {
+            const int a = edge < cells ? edge : edge - cells;
+            const int b = edge < cells ? a + 1 : a + cols;
+            const int ra = find(a);
+            const int rb = find(b);
+            if (ra == rb) continue;
+
+            parent[ra] = rb;
+            carve(maze, a, b);
+            if (++joined == cells - 1) break;
+        }
+
+        maze.clear_gen();
+        maze.open_entrance_exit();
+    }
+
+    void BacktrackerGenerator::generate(Maze& maze, const std::uint64_t seed, unsigned) const {
+        const int rows = maze.getRows();
+        const int cols = maze.getCols();
+        const int cells = rows * cols;
+        SplitMix64 rng(seed);
+
+        fill_walls(maze);
+        std::vector<std::uint8_t> visited(cells, 0);
+        std::vector<int> stack;
+        stack.push_back(0);
+        visited[0] = 1;
+
+        while (!stack.empty()) {
+            const int cell = stack.back();
+
+            int options[4];
+            int count = 0;
+            for (int dir = 0; dir < 4; dir++)
+                if (const int next = neighbor(cell, dir, rows, cols); next >= 0 && !visited[next])
+                    options[count++] = next;
+
+            if (count == 0) {
+                stack.pop_back();
+                continue;
+            }
+
+            const int next = options[rng.below(count)];
+            carve(maze, cell, next);
+            visited[next] = 1;
+            stack.push_back(next);
+        }
+
+        maze.clear_gen();
+        maze.open_entrance_exit();
+    }
+}
@@ -0,0 +1,220 @@
+//
+// Hierarchical pathfinding (HPA*): cluster abstraction with exact intra-cluster distances
+//
+
+#include <hpa.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <threadpool.h>
+
+namespace course {
+    namespace {
+        constexpr std::uint32_t INF = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t manhattan(const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            return std::abs(a.first - b.first) + std::abs(a.second - b.second);
+        }
+    }
+
+    HpaGraph::HpaGraph(const Maze& maze, const int cluster_size, const unsigned threads)
+        : maze_(maze), size_(cluster_size) {
+        if (size_ < 2) throw std::invalid_argument("HPA* cluster size must be at least 2");
+
+        const auto start = std::chrono::steady_clock::now();
+        const int rows = maze_.getRows();
+        const int cols = maze_.getCols();
+        clustersX_ = (cols + size_ - 1) / size_;
+        clustersY_ = (rows + size_ - 1) / size_;
+        for (int cy = 0; cy < clustersY_; cy++) {
+            for (int cx = 0; cx < clustersX_; cx++) {
+                const int row0 = cy * size_;
+                const int col0 = cx * size_;
+                clusters_.push_back({row0, col0, std::min(size_, rows - row0), std::min(size_, cols - col0), {}});
+            }
+        }
+
+        // Inter-cluster edges: every open passage across a cluster border
+        auto link = [this](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            const int na = add_node(a);
+            const int nb = add_node(b);
+            edges_[na].push_back({nb, 1});
+            edges_[nb].push_back({na, 1});
+        };
+        for (int c = size_ - 1; c + 1 < cols; c += size_)
+            for (int r = 0; r < rows; r++)
+                if (!maze_.get_v_walls()(r, c)) link({r, c}, {r, c + 1});
+        for (int r = size_ - 1; r + 1 < rows; r += size_)
+            for (int c = 0; c < cols; c++)
+                if (!maze_.get_h_walls()(r, c)) link({r, c}, {r + 1, c});
+
+        // Intra-cluster edges: one local BFS per abstract node. Each cluster only appends
+        // to the edge lists of its own nodes, so clusters run in parallel without locks
+        ThreadPool pool(threads);
+        pool.parallel_for(clusters_.size(), [this](const size_t i) {
+            const Cluster& cluster = clusters_[i];
+            std::vector<std::uint32_t> dist;
+            for (const int from : cluster.nodes) {
+                cluster_bfs(cluster, nodeCells_[from], dist, nullptr);
+                for (const int to : cluster.nodes) {
+                    const auto [r, c] = nodeCells_[to];
+                    const std::uint32_t d = dist[(r - cluster.row0) * cluster.cols + c - cluster.col0];
+                    if (to != from && d != INF) edges_[from].push_back({to, d});
+                }
+            }
+        });
+
+        buildStats_.clusters = clusters_.size();
+        buildStats_.nodes = nodeCells_.size();
+        for (const auto& list : edges_)
+            buildStats_.edges += list.size();
+        buildStats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    int HpaGraph::add_node(const std::pair<int, int>& cell) {
+        const auto [it, inserted] = nodeOf_.try_emplace(key(cell), static_cast<int>(nodeCells_.size()));
+        if (inserted) {
+            nodeCells_.push_back(cell);
+            edges_.emplace_back();
+            clusters_[cluster_of(cell)].nodes.push_back(it->second);
+        }
+        return it->second;
+    }
+
+    size_t HpaGraph::cluster_bfs(const Cluster& cluster, const std::pair<int, int>& source,
+                                 std::vector<std::uint32_t>& dist, std::vector<int>* parent) const {
+        const auto& vWalls = maze_.get_v_walls();
+        const auto& hWalls = maze_.get_h_walls();
+        const int cols = cluster.cols;
+        dist.assign(static_cast<size_t>(cluster.rows) * cols, INF);
+        if (parent) parent->assign(dist.size(), -1);
+
+        std::vector<int> queue;
+        queue.reserve(dist.size());
+        const int first = (source.first - cluster.row0) * cols + source.second - cluster.col0;
+        dist[first] = 0;
+        queue.push_back(first);
+
+        for (size_t head = 0; head < queue.size(); head++) {
+            const int cell = queue[head];
+            const int lr = cell / cols;
+            const int lc = cell % cols;
+            const int r = cluster.row0 + lr;
+            const int c = cluster.col0 + lc;
+            auto visit = [&](const int next) {
+                if (dist[next] != INF) return;
+                dist[next] = dist[cell] + 1;
+                if (parent) (*parent)[next] = cell;
+                queue.push_back(next);
+            };
+            if (lr > 0 && !hWalls(r - 1, c)) visit(cell - cols);
+            if (lr + 1 < cluster.rows && !hWalls(r, c)) visit(cell + cols);
+            if (lc > 0 && !vWalls(r, c - 1)) visit(cell - 1);
+            if (lc + 1 < cols && !vWalls(r, c)) visit(cell + 1);
+        }
+        return queue.size();
+    }
+
+    // Appends the in-cluster shortest path from 'from' (already on the path) to 'to'
+    size_t HpaGraph::refine(const Cluster& cluster, const std::pair<int, int>& from,
+                            const std::pair<int, int>& to, PathCodec& path) const {
+        std::vector<std::uint32_t> dist;
+        std::vector<int> parent;
+        const size_t visited = cluster_bfs(cluster, from, dist, &parent);
+
+        std::vector<std::pair<int, int>> cells;
+        for (int cell = (to.first - cluster.row0) * cluster.cols + to.second - cluster.col0;
+             parent[cell] != -1; cell = parent[cell]) {
+            cells.emplace_back(cluster.row0 + cell / cluster.cols, cluster.col0 + cell % cluster.cols);
+        }
+        for (auto it = cells.rbegin(); it != cells.rend(); ++it)
+            path.push_back(*it);
+        return visited;
+    }
+
+    PathCodec HpaGraph::find_path(const std::pair<int, int>& start, const std::pair<int, int>& goal,
+                                  QueryStats* stats) const {
+        QueryStats local_stats;
+        QueryStats& query = stats ? *stats : local_stats;
+        query = QueryStats();
+        const auto inside = [this](const std::pair<int, int>& cell) {
+            return cell.first >= 0 && cell.first < maze_.getRows() && cell.second >= 0 && cell.second < maze_.getCols();
+        };
+        if (!inside(start) || !inside(goal)) throw std::out_of_range("Path endpoint outside the maze");
+
+        PathCodec path;
+        if (start == goal) {
+            path.push_back(start);
+            return path;
+        }
+
+        // Connect both endpoints to the abstract nodes of their clusters
+        const Cluster& startCluster = clusters_[cluster_of(start)];
+        const Cluster& goalCluster = clusters_[cluster_of(goal)];
+        std::vector<std::uint32_t> fromStart, toGoal;
+        query.cells_expanded += cluster_bfs(startCluster, start, fromStart, nullptr);
+        query.cells_expanded += cluster_bfs(goalCluster, goal, toGoal, nullptr);
+        const auto local = [](const Cluster& cluster, const std::pair<int, int>& cell) {
+            return (cell.first - cluster.row0) * cluster.cols + cell.second - cluster.col0;
+        };
+
+        // A* over the abstract graph with two virtual nodes for the endpoints
+        const int n = static_cast<int>(nodeCells_.size());
+        const int S = n;
+        const int G = n + 1;
+        std::vector<std::uint32_t> g(n + 2, INF);
+        std::vector<int> came(n + 2, -1);
+        std::vector<bool> closed(n + 2, false);
+        using Item = std::pair<std::uint32_t, int>;
+        std::priority_queue<Item, std::vector<Item>, std::greater<>> open;
+
+        auto relax = [&](const int from, const int to, const std::uint32_t cost) {
+            if (cost == INF || g[from] + cost >= g[to]) return;
+            g[to] = g[from] + cost;
+            came[to] = from;
+            open.emplace(g[to] + (to == G ? 0 : manhattan(nodeCells_[to], goal)), to);
+        };
+
+        g[S] = 0;
+        open.emplace(manhattan(start, goal), S);
+        while (!open.empty()) {
+            const int u = open.top().second;
+            open.pop();
+            if (closed[u]) continue;
+            closed[u] = true;
+            query.abstract_expanded++;
+            if (u == G) break;
+
+            if (u == S) {
+                for (const int v : startCluster.nodes)
+                    relax(S, v, fromStart[local(startCluster, nodeCells_[v])]);
+                if (&startCluster == &goalCluster) relax(S, G, fromStart[local(startCluster, goal)]);
+                continue;
+            }
+            for (const Edge& edge : edges_[u])
+                relax(u, edge.to, edge.cost);
+            if (cluster_of(nodeCells_[u]) == cluster_of(goal))
+                relax(u, G, toGoal[local(goalCluster, nodeCells_[u])]);
+        }
+        if (came[G] == -1) return path;
+
+        // Refine: inter-cluster hops are single steps, intra-cluster hops a local BFS
+        std::vector<int> abstract;
+        for (int v = G; v != -1; v = came[v])
+            abstract.push_back(v);
+        std::ranges::reverse(abstract);
+
+        const auto cell_of = [&](const int v) { return v == S ? start : v == G ? goal : nodeCells_[v]; };
+        path.push_back(start);
+        for (size_t i = 1; i < abstract.size(); i++) {
+            const auto from = cell_of(abstract[i - 1]);
+            const auto to = cell_of(abstract[i]);
+            if (cluster_of(from) != cluster_of(to)) path.push_back(to);
+            else if (from != to) query.cells_expanded += refine(clusters_[cluster_of(from)], from, to, path);
+        }
+        return path;
+    }
+}
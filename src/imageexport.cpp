@@ -0,0 +1,199 @@
+//
+// Streaming PBM/PGM export: walls as black pixels, one band of rows in memory
+//
+
+#include <imageexport.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <tiled.h>
+#include <vector>
+
+namespace course {
+    namespace {
+        enum Unit : std::uint8_t { Wall = 0, Floor = 1, Trail = 2 };
+        constexpr std::uint8_t GREY_LEVELS[] = {0, 255, 110};
+
+        // Right and bottom walls of rows [row0, row0 + rows), bit-packed; the path
+        // masks mark cells and the passages to their right and below
+        struct Band {
+            int row0 = 0;
+            int rows = 0;
+            size_t stride = 0;
+            std::vector<std::uint64_t> v, h, cell, right, down;
+
+            void reset(const int first, const int count, const int cols, const bool with_path) {
+                row0 = first;
+                rows = count;
+                stride = (cols + 63) / 64;
+                v.assign(stride * count, 0);
+                h.assign(stride * count, 0);
+                for (auto* mask : {&cell, &right, &down})
+                    mask->assign(with_path ? stride * count : 0, 0);
+            }
+            static bool test(const std::vector<std::uint64_t>& bits, const size_t i) {
+                return bits[i >> 6] >> (i & 63) & 1;
+            }
+            static void set(std::vector<std::uint64_t>& bits, const size_t i) {
+                bits[i >> 6] |= std::uint64_t{1} << (i & 63);
+            }
+            size_t index(const int row, const int col) const { return (row - row0) * stride * 64 + col; }
+        };
+
+        using BandLoader = std::function<void(Band&)>;
+
+        // Marks the part of the path inside the band; the path is walked once per band
+        void mark_path(Band& band, const PathCodec& path) {
+            const auto inside = [&band](const int row) { return row >= band.row0 && row < band.row0 + band.rows; };
+            std::pair<int, int> prev{-1, -1};
+            for (const auto& cell : path) {
+                if (inside(cell.first)) Band::set(band.cell, band.index(cell.first, cell.second));
+                if (prev.first >= 0) {
+                    const int r = std::min(prev.first, cell.first);
+                    const int c = std::min(prev.second, cell.second);
+                    if (inside(r)) Band::set(prev.first == cell.first ? band.right : band.down, band.index(r, c));
+                }
+                prev = cell;
+            }
+        }
+
+        class ImageStream {
+        public:
+            ImageStream(const std::string& filename, const int units_x, const int units_y, const int scale,
+                        const bool grey)
+                : file_(filename, std::ios::binary), scale_(scale), grey_(grey) {
+                if (!file_.is_open()) throw std::runtime_error("Could not open file for writing: " + filename);
+                width_ = static_cast<size_t>(units_x) * scale;
+                file_ << (grey ? "P5\n" : "P4\n") << width_ << " " << static_cast<size_t>(units_y) * scale << "\n";
+                if (grey) file_ << "255\n";
+                pixels_.resize(grey ? width_ : (width_ + 7) / 8);
+            }
+
+            void write_units(const std::vector<std::uint8_t>& units) {
+                size_t x = 0;
+                if (grey_) {
+                    for (const std::uint8_t unit : units)
+                        for (int s = 0; s < scale_; s++)
+                            pixels_[x++] = GREY_LEVELS[unit];
+                } else if (scale_ == 1) {
+                    // Eight units per output byte, MSB first
+                    const size_t full = units.size() / 8;
+                    for (size_t b = 0; b < full; b++) {
+                        const std::uint8_t* u = &units[b * 8];
+                        std::uint8_t byte = 0;
+                        for (int k = 0; k < 8; k++)
+                            byte |= static_cast<std::uint8_t>(u[k] == Wall) << (7 - k);
+                        pixels_[b] = byte;
+                    }
+                    if (full < pixels_.size()) {
+                        std::uint8_t byte = 0;
+                        for (size_t k = full * 8; k < units.size(); k++)
+                            byte |= static_cast<std::uint8_t>(units[k] == Wall) << (7 - (k & 7));
+                        pixels_[full] = byte;
+                    }
+                } else {
+                    std::ranges::fill(pixels_, 0);
+                    for (const std::uint8_t unit : units) {
+                        for (int s = 0; s < scale_; s++, x++)
+                            if (unit == Wall) pixels_[x >> 3] |= 0x80 >> (x & 7);
+                    }
+                }
+                for (int s = 0; s < scale_; s++)
+                    file_.write(reinterpret_cast<const char*>(pixels_.data()), static_cast<std::streamsize>(pixels_.size()));
+            }
+
+            void finish() {
+                file_.close();
+                if (!file_) throw std::runtime_error("Failed writing image");
+            }
+
+        private:
+            std::ofstream file_;
+            int scale_;
+            bool grey_;
+            size_t width_{0};
+            std::vector<std::uint8_t> pixels_;
+        };
+
+        void stream_image(const int rows, const int cols, const std::pair<int, int>& entrance,
+                          const int band_rows, const BandLoader& load, const PathCodec* path,
+                          const std::string& filename, const int scale) {
+            if (rows <= 0 || cols <= 0) throw std::invalid_argument("Cannot export an empty maze");
+            if (scale < 1 || scale > 64) throw std::invalid_argument("Image scale must be in 1..64");
+
+            const bool with_path = path && !path->empty();
+            ImageStream image(filename, 2 * cols + 1, 2 * rows + 1, scale, with_path);
+            std::vector<std::uint8_t> units(2 * cols + 1);
+
+            // Top border; the entrance is drawn open like print_maze does
+            std::ranges::fill(units, Wall);
+            if (entrance.first == 0) units[2 * entrance.second + 1] = Floor;
+            image.write_units(units);
+
+            Band band;
+            for (int row0 = 0; row0 < rows; row0 += band_rows) {
+                band.reset(row0, std::min(band_rows, rows - row0), cols, with_path);
+                load(band);
+                if (with_path) mark_path(band, *path);
+
+                for (int r = row0; r < row0 + band.rows; r++) {
+                    const auto floor = [&](const std::vector<std::uint64_t>& mask, const size_t i) {
+                        return with_path && Band::test(mask, i) ? Trail : Floor;
+                    };
+
+                    // Cells and the walls to their right
+                    units[0] = entrance.first == r && entrance.second == 0 ? Floor : Wall;
+                    for (int c = 0; c < cols; c++) {
+                        const size_t i = band.index(r, c);
+                        units[2 * c + 1] = floor(band.cell, i);
+                        units[2 * c + 2] = Band::test(band.v, i) ? Wall : floor(band.right, i);
+                    }
+                    image.write_units(units);
+
+                    // Walls below and the corners between them
+                    units[0] = Wall;
+                    for (int c = 0; c < cols; c++) {
+                        const size_t i = band.index(r, c);
+                        units[2 * c + 1] = Band::test(band.h, i) ? Wall : floor(band.down, i);
+                        units[2 * c + 2] = Wall;
+                    }
+                    image.write_units(units);
+                }
+            }
+            image.finish();
+        }
+    }
+
+    void export_image(const Maze& maze, const std::string& filename, const int scale, const PathCodec* path) {
+        const auto& vWalls = maze.get_v_walls();
+        const auto& hWalls = maze.get_h_walls();
+        const int cols = maze.getCols();
+
+        stream_image(maze.getRows(), cols, maze.get_entrance(), 256, [&](Band& band) {
+            for (int r = band.row0; r < band.row0 + band.rows; r++) {
+                for (int c = 0; c < cols; c++) {
+                    if (vWalls(r, c)) Band::set(band.v, band.index(r, c));
+                    if (hWalls(r, c)) Band::set(band.h, band.index(r, c));
+                }
+            }
+        }, path, filename, scale);
+    }
+
+    void export_image(TiledMazeReader& reader, const std::string& filename, const int scale, const PathCodec* path) {
+        stream_image(reader.getRows(), reader.getCols(), reader.get_entrance(), reader.tile_size(), [&](Band& band) {
+            const int tile_row = band.row0 / reader.tile_size();
+            for (int tx = 0; tx < reader.tiles_x(); tx++) {
+                // Tile sizes are multiples of 64, so tile rows start on a band word: copy words
+                const WallTile tile = reader.load_tile(tile_row, tx);
+                for (int r = 0; r < tile.rows; r++) {
+                    const size_t at = band.index(tile.row0 + r, tile.col0) >> 6;
+                    std::copy_n(&tile.vBits[r * tile.stride], tile.stride, &band.v[at]);
+                    std::copy_n(&tile.hBits[r * tile.stride], tile.stride, &band.h[at]);
+                }
+            }
+        }, path, filename, scale);
+    }
+}
@@ -0,0 +1,127 @@
+//
+// Landmark distance tables for ALT (A*, landmarks, triangle inequality) heuristics
+//
+
+#include <landmarks.h>
+
+#include <algorithm>
+#include <chrono>
+#include <distance.h>
+#include <stdexcept>
+#include <threadpool.h>
+
+namespace course {
+    namespace {
+        // Border cells in clockwise order starting at the top-left corner
+        std::pair<int, int> perimeter_cell(const int rows, const int cols, long long step) {
+            if (rows == 1) return {0, static_cast<int>(step % cols)};
+            if (cols == 1) return {static_cast<int>(step % rows), 0};
+            const long long length = 2LL * (rows + cols) - 4;
+            step %= length;
+            if (step < cols) return {0, static_cast<int>(step)};
+            step -= cols - 1;
+            if (step < rows) return {static_cast<int>(step), cols - 1};
+            step -= rows - 1;
+            if (step < cols) return {rows - 1, static_cast<int>(cols - 1 - step)};
+            step -= cols - 1;
+            return {static_cast<int>(rows - 1 - step), 0};
+        }
+    }
+
+    Landmarks::Landmarks(const Maze& maze, const int count, const unsigned threads, const Selection selection)
+        : count_(count), cols_(maze.getCols()) {
+        if (count_ < 1 || count_ > 64) throw std::invalid_argument("Landmark count must be in 1..64");
+        const auto start = std::chrono::steady_clock::now();
+        const int rows = maze.getRows();
+        const size_t cells = static_cast<size_t>(rows) * cols_;
+        if (cells == 0) throw std::invalid_argument("Landmarks need a non-empty maze");
+
+        std::vector<DistanceField> fields(count_);
+        if (selection == Selection::Perimeter) {
+            const long long length = rows == 1 || cols_ == 1 ? static_cast<long long>(cells)
+                                                             : 2LL * (rows + cols_) - 4;
+            for (int k = 0; k < count_; k++)
+                cells_.push_back(perimeter_cell(rows, cols_, length * k / count_));
+
+            ThreadPool pool(threads);
+            pool.parallel_for(cells_.size(), [&](const size_t k) {
+                fields[k] = DistanceField::compute(maze, cells_[k], 1);
+            });
+        } else {
+            // Start from the cell farthest from the top-left corner, then keep adding the
+            // cell whose nearest landmark is farthest away
+            const auto seed = DistanceField::compute(maze, {0, 0}, threads);
+            std::vector<std::uint32_t> nearest(cells, 0);
+            size_t next = std::ranges::max_element(seed.data(), [](const auto a, const auto b) {
+                return (a == UNREACHABLE ? 0 : a) < (b == UNREACHABLE ? 0 : b);
+            }) - seed.data().begin();
+
+            for (int k = 0; k < count_; k++) {
+                cells_.emplace_back(static_cast<int>(next / cols_), static_cast<int>(next % cols_));
+                fields[k] = DistanceField::compute(maze, cells_.back(), threads);
+
+                const auto& dist = fields[k].data();
+                for (size_t i = 0; i < cells; i++) {
+                    const std::uint32_t d = dist[i] == DistanceField::UNREACHABLE ? 0 : dist[i];
+                    nearest[i] = k == 0 ? d : std::min(nearest[i], d);
+                }
+                next = std::ranges::max_element(nearest) - nearest.begin();
+            }
+        }
+
+        // Interleave the tables cell-major, 16 bits wide if every distance fits
+        std::uint32_t longest = 0;
+        for (const auto& field : fields)
+            longest = std::max(longest, field.max_distance());
+        stats_.narrow = longest < NARROW_UNREACHABLE;
+        if (stats_.narrow) narrow_.resize(cells * count_);
+        else wide_.resize(cells * count_);
+
+        for (int k = 0; k < count_; k++) {
+            const auto& dist = fields[k].data();
+            for (size_t i = 0; i < cells; i++) {
+                if (stats_.narrow) {
+                    narrow_[i * count_ + k] = dist[i] == DistanceField::UNREACHABLE
+                        ? NARROW_UNREACHABLE : static_cast<std::uint16_t>(dist[i]);
+                } else {
+                    wide_[i * count_ + k] = dist[i];
+                }
+            }
+        }
+
+        stats_.bytes = narrow_.size() * sizeof(std::uint16_t) + wide_.size() * sizeof(std::uint32_t);
+        stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Landmarks::Selection Landmarks::parse_selection(const std::string& name) {
+        if (name == "farthest") return Selection::Farthest;
+        if (name == "perimeter") return Selection::Perimeter;
+        throw std::invalid_argument("Unknown landmark selection '" + name + "' (farthest, perimeter)");
+    }
+
+    void Landmarks::load(const std::uint32_t cell, std::uint32_t* out) const {
+        for (int k = 0; k < count_; k++)
+            out[k] = distance(cell, k);
+    }
+
+    std::uint32_t Landmarks::lower_bound(const std::uint32_t* goal, const std::uint32_t cell) const {
+        std::uint32_t best = 0;
+        const size_t base = static_cast<size_t>(cell) * count_;
+        if (!narrow_.empty()) {
+            const std::uint16_t* row = &narrow_[base];
+            for (int k = 0; k < count_; k++) {
+                if (row[k] == NARROW_UNREACHABLE || goal[k] == UNREACHABLE) continue;
+                const std::uint32_t d = row[k] > goal[k] ? row[k] - goal[k] : goal[k] - row[k];
+                best = std::max(best, d);
+            }
+        } else {
+            const std::uint32_t* row = &wide_[base];
+            for (int k = 0; k < count_; k++) {
+                if (row[k] == UNREACHABLE || goal[k] == UNREACHABLE) continue;
+                const std::uint32_t d = row[k] > goal[k] ? row[k] - goal[k] : goal[k] - row[k];
+                best = std::max(best, d);
+            }
+        }
+        return best;
+    }
+}
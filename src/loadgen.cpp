@@ -0,0 +1,348 @@
+//
+// Synthetic players driving race mode, with throughput and latency figures
+//
+
+#include <loadgen.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <racemode.h>
+#include <raceserver.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace course {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+        using Direction = RaceServer::Direction;
+
+        // Headings in clockwise order, for the right-hand rule
+        constexpr Direction CLOCKWISE[] = {Direction::Up, Direction::Right, Direction::Down, Direction::Left};
+
+        std::uint64_t elapsed_ns(const Clock::time_point from, const Clock::time_point to) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+        }
+
+        std::string format_ns(const double ns) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(1);
+            if (ns < 1e3) text << ns << "ns";
+            else if (ns < 1e6) text << ns / 1e3 << "us";
+            else text << ns / 1e6 << "ms";
+            return text.str();
+        }
+
+        std::pair<int, int> step(const std::pair<int, int>& cell, const Direction direction) {
+            switch (direction) {
+                case Direction::Up: return {cell.first - 1, cell.second};
+                case Direction::Down: return {cell.first + 1, cell.second};
+                case Direction::Left: return {cell.first, cell.second - 1};
+                default: return {cell.first, cell.second + 1};
+            }
+        }
+
+        bool is_open(const Maze& maze, const std::pair<int, int>& cell, const Direction direction) {
+            const auto [row, col] = cell;
+            switch (direction) {
+                case Direction::Up: return row > 0 && !maze.get_h_walls()(row - 1, col);
+                case Direction::Down: return row + 1 < maze.getRows() && !maze.get_h_walls()(row, col);
+                case Direction::Left: return col > 0 && !maze.get_v_walls()(row, col - 1);
+                default: return col + 1 < maze.getCols() && !maze.get_v_walls()(row, col);
+            }
+        }
+
+        bool apply_move(RaceMode& race, const Direction direction) {
+            switch (direction) {
+                case Direction::Up: return race.move_up();
+                case Direction::Down: return race.move_down();
+                case Direction::Left: return race.move_left();
+                default: return race.move_right();
+            }
+        }
+
+        struct Player {
+            RaceServer::SessionId id = 0;
+            std::pair<int, int> position;
+            Direction heading = Direction::Down;
+            std::mt19937_64 rng;
+
+            void restart(const Maze& maze) {
+                position = maze.get_entrance();
+                heading = Direction::Down;
+            }
+        };
+
+        Direction choose_move(const Maze& maze, const LoadgenOptions& options, Player& player,
+                              const std::function<RaceMode::Hint()>& hint) {
+            const auto random_move = [&] { return static_cast<Direction>(player.rng() & 3); };
+
+            switch (options.strategy) {
+                case LoadgenOptions::Strategy::WallFollower: {
+                    // Right-hand rule: right, straight, left, back
+                    const int h = static_cast<int>(std::ranges::find(CLOCKWISE, player.heading) - CLOCKWISE);
+                    for (const int turn : {1, 0, 3, 2}) {
+                        const Direction direction = CLOCKWISE[(h + turn) % 4];
+                        if (is_open(maze, player.position, direction)) return direction;
+                    }
+                    return player.heading;
+                }
+                case LoadgenOptions::Strategy::Optimal: {
+                    if (std::uniform_real_distribution<double>(0.0, 1.0)(player.rng) < options.noise) {
+                        return random_move();
+                    }
+                    const RaceMode::Hint next = hint();
+                    if (!next.available || next.remaining == 0) return random_move();
+                    for (const Direction direction : CLOCKWISE) {
+                        if (step(player.position, direction) == next.next) return direction;
+                    }
+                    return random_move();
+                }
+                default:
+                    return random_move();
+            }
+        }
+
+        LoadgenReport run_memory(const Maze& maze, const LoadgenOptions& options) {
+            RaceServer server(maze);
+            std::vector<Player> players(options.players);
+            for (size_t i = 0; i < players.size(); i++) {
+                players[i].id = server.create_session();
+                players[i].restart(maze);
+                players[i].rng.seed(options.seed + i);
+            }
+
+            const unsigned threads = std::max(1u, std::min<unsigned>(options.threads, options.players));
+            std::vector<LoadgenReport> partial(threads);
+            const auto start = Clock::now();
+
+            // Client t drives players t, t + threads, ... one move each per round
+            std::vector<std::thread> clients;
+            for (unsigned t = 0; t < threads; t++) {
+                clients.emplace_back([&, t] {
+                    LoadgenReport& report = partial[t];
+                    for (int round = 0; round < options.moves; round++) {
+                        for (size_t i = t; i < players.size(); i += threads) {
+                            Player& player = players[i];
+                            const Direction direction = choose_move(maze, options, player,
+                                [&] { return server.hint(player.id); });
+
+                            const auto before = Clock::now();
+                            const auto result = server.move(player.id, direction);
+                            report.latency.add(elapsed_ns(before, Clock::now()));
+                            report.moves++;
+
+                            if (result == RaceServer::MoveResult::Blocked) {
+                                report.blocked++;
+                                continue;
+                            }
+                            player.position = step(player.position, direction);
+                            player.heading = direction;
+                            if (result == RaceServer::MoveResult::Finished) {
+                                report.finished++;
+                                server.close_session(player.id);
+                                player.id = server.create_session();
+                                player.restart(maze);
+                            }
+                        }
+                    }
+                });
+            }
+            for (auto& client : clients)
+                client.join();
+
+            LoadgenReport report;
+            report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            for (const auto& part : partial) {
+                report.moves += part.moves;
+                report.blocked += part.blocked;
+                report.finished += part.finished;
+                report.latency.merge(part.latency);
+            }
+            return report;
+        }
+
+        // Runs in a scratch directory so race files of the real working directory survive
+        class ScratchDirectory {
+        public:
+            explicit ScratchDirectory(const std::uint64_t seed) : previous_(fs::current_path()) {
+                path_ = fs::temp_directory_path() /
+                        ("maze_loadgen_" + std::to_string(seed) + "_" +
+                         std::to_string(Clock::now().time_since_epoch().count()));
+                fs::create_directories(path_);
+                fs::current_path(path_);
+            }
+            ~ScratchDirectory() {
+                std::error_code ignored;
+                fs::current_path(previous_, ignored);
+                fs::remove_all(path_, ignored);
+            }
+
+        private:
+            fs::path previous_;
+            fs::path path_;
+        };
+
+        LoadgenReport run_persistent(const Maze& maze, const LoadgenOptions& options) {
+            ScratchDirectory scratch(options.seed);
+
+            RaceMode::Options race_options;
+            race_options.out = nullptr;
+            race_options.optimal = std::async(std::launch::async, RaceMode::solve_optimal, std::cref(maze)).share();
+
+            LoadgenReport report;
+            const auto start = Clock::now();
+            for (int i = 0; i < options.players; i++) {
+                Player player;
+                player.rng.seed(options.seed + i);
+                player.restart(maze);
+                RaceMode(maze, race_options).start_race();
+
+                for (int m = 0; m < options.moves; m++) {
+                    // One CLI move: load the race, move, save it again
+                    const auto before_load = Clock::now();
+                    auto race = std::make_unique<RaceMode>(maze, race_options);
+                    const std::uint64_t load_ns = elapsed_ns(before_load, Clock::now());
+
+                    const Direction direction = choose_move(maze, options, player,
+                        [&] { return race->get_hint(); });
+
+                    const auto before_move = Clock::now();
+                    const bool moved = apply_move(*race, direction);
+                    const bool finished = race->is_race_finished();
+                    race.reset();
+                    report.latency.add(load_ns + elapsed_ns(before_move, Clock::now()));
+                    report.moves++;
+
+                    if (!moved) {
+                        report.blocked++;
+                        continue;
+                    }
+                    player.position = step(player.position, direction);
+                    player.heading = direction;
+                    if (finished) {
+                        report.finished++;
+                        player.restart(maze);
+                        RaceMode(maze, race_options).start_race();
+                    }
+                }
+                RaceMode(maze, race_options).reset_race();
+            }
+            report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            return report;
+        }
+    }
+
+    int LatencyHistogram::bucket_of(const std::uint64_t ns) {
+        if (ns < SUB_BUCKETS) return static_cast<int>(ns);
+        const int exponent = std::bit_width(ns) - 1;
+        const int sub = static_cast<int>(ns >> (exponent - 3) & (SUB_BUCKETS - 1));
+        return (exponent - 2) * SUB_BUCKETS + sub;
+    }
+
+    std::uint64_t LatencyHistogram::upper_bound(const int bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        const int exponent = bucket / SUB_BUCKETS + 2;
+        const std::uint64_t width = std::uint64_t{1} << (exponent - 3);
+        return (SUB_BUCKETS + bucket % SUB_BUCKETS) * width + width - 1;
+    }
+
+    void LatencyHistogram::add(const std::uint64_t ns) {
+        buckets_[bucket_of(ns)]++;
+        count_++;
+        total_ += ns;
+        max_ = std::max(max_, ns);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKETS; i++)
+            buckets_[i] += other.buckets_[i];
+        count_ += other.count_;
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    std::uint64_t LatencyHistogram::percentile(const double p) const {
+        if (count_ == 0) return 0;
+        const auto rank = static_cast<std::uint64_t>(std::clamp(p, 0.0, 1.0) * (count_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += buckets_[i];
+            if (seen >= rank) return std::min(upper_bound(i), max_);
+        }
+        return max_;
+    }
+
+    void LatencyHistogram::print(std::ostream& out) const {
+        // Collapse sub-buckets to powers of two for display
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> rows;
+        for (int i = 0; i < BUCKETS; i++) {
+            if (buckets_[i] == 0) continue;
+            const std::uint64_t bound = std::bit_ceil(upper_bound(i) + 1);
+            if (!rows.empty() && rows.back().first == bound) rows.back().second += buckets_[i];
+            else rows.emplace_back(bound, buckets_[i]);
+        }
+
+        std::uint64_t peak = 0;
+        for (const auto& row : rows)
+            peak = std::max(peak, row.second);
+        for (const auto& [bound, count] : rows) {
+            out << "  < " << std::setw(8) << format_ns(static_cast<double>(bound))
+                << std::setw(10) << count << "  "
+                << std::string(static_cast<size_t>(40.0 * count / peak + 0.5), '#') << "\n";
+        }
+    }
+
+    LoadgenOptions::Strategy LoadgenOptions::parse_strategy(const std::string& name) {
+        if (name == "random") return Strategy::Random;
+        if (name == "wall") return Strategy::WallFollower;
+        if (name == "optimal") return Strategy::Optimal;
+        throw std::invalid_argument("Unknown strategy '" + name + "' (random, wall, optimal)");
+    }
+
+    LoadgenOptions::Mode LoadgenOptions::parse_mode(const std::string& name) {
+        if (name == "memory") return Mode::Memory;
+        if (name == "persistent") return Mode::Persistent;
+        throw std::invalid_argument("Unknown mode '" + name + "' (memory, persistent)");
+    }
+
+    void LoadgenReport::print(const LoadgenOptions& options, std::ostream& out) const {
+        static const char* STRATEGIES[] = {"random", "wall", "optimal"};
+        const bool memory = options.mode == LoadgenOptions::Mode::Memory;
+
+        out << "Race load test: " << options.players << " players, "
+            << STRATEGIES[static_cast<int>(options.strategy)] << " strategy, "
+            << (memory ? "memory, " + std::to_string(options.threads) + " threads" : std::string("persistent"))
+            << "\n";
+        out << "Moves:    " << moves << " (" << std::fixed << std::setprecision(1)
+            << (moves ? 100.0 * blocked / moves : 0.0) << "% blocked), "
+            << finished << " races finished\n";
+        out << "Time:     " << std::setprecision(2) << seconds * 1e3 << " ms, "
+            << (seconds > 0 ? moves / seconds / 1e3 : 0.0) << " Kmoves/s\n";
+        out << "Latency:  mean " << format_ns(latency.mean())
+            << "  p50 " << format_ns(static_cast<double>(latency.percentile(0.50)))
+            << "  p90 " << format_ns(static_cast<double>(latency.percentile(0.90)))
+            << "  p99 " << format_ns(static_cast<double>(latency.percentile(0.99)))
+            << "  p99.9 " << format_ns(static_cast<double>(latency.percentile(0.999)))
+            << "  max " << format_ns(static_cast<double>(latency.max())) << "\n\n";
+        latency.print(out);
+    }
+
+    LoadgenReport run_loadgen(const Maze& maze, const LoadgenOptions& options) {
+        if (options.players <= 0 || options.moves <= 0 || options.threads == 0) {
+            throw std::invalid_argument("Players, moves and threads must be positive");
+        }
+        return options.mode == LoadgenOptions::Mode::Memory ? run_memory(maze, options)
+                                                            : run_persistent(maze, options);
+    }
+}
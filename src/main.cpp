@@ -2,35 +2,115 @@
 #include <sstream>
 #include <filesystem>
 #include <fstream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include "analysis.h"
+#include "anytime.h"
 #include "astar.h"
+#include "bench.h"
+#include "distance.h"
+#include "generator.h"
+#include "hpa.h"
+#include "imageexport.h"
+#include "loadgen.h"
 #include "maze.h"
 #include "racemode.h"
+#include "route.h"
+#include "rowpipeline.h"
+#include "raceplay.h"
+#include "searchcore.h"
+#include "solutioncache.h"
+#include "targetgen.h"
+#include "tiled.h"
+#include "tiledsolver.h"
+#include "validator.h"
 
 namespace fs = std::filesystem;
 
 const std::string TEMP_FILE = "maze_temp.txt";
 const std::string RACE_RESULTS_FILE = "race_results.txt";
+const std::string DISTANCE_FILE = "maze_temp.dist";
+
+// Debug builds check every generated maze; release builds only with --validate
+#ifdef NDEBUG
+constexpr bool VALIDATE_GENERATED = false;
+#else
+constexpr bool VALIDATE_GENERATED = true;
+#endif
 
 void print_help() {
     std::cout << "Maze Path Finder - Persistent Version with Race Mode\n";
     std::cout << "  maze.exe [command] [options]\n\n";
     std::cout << "Commands:\n";
     std::cout << "  help                    - Show this help message\n";
-    std::cout << "  gen <rows> <cols>       - Generate new maze (auto-saves)\n";
+    std::cout << "  gen <rows> <cols> [--algo name] [--seed N] [--validate] [--stats] [--farthest]\n";
+    std::cout << "                          - Generate new maze (auto-saves); --farthest puts the entrance and\n";
+    std::cout << "                            exit at the ends of the longest path between border cells;\n";
+    std::cout << "                            --stats counts dead ends, corridors and junctions as rows are made\n";
+    std::cout << "  gen_target <rows> <cols> --min-path L [--min-dead-ends R] [--threads N] [--algo name] [--seed N]\n";
+    std::cout << "             [--farthest] [--max-candidates N]\n";
+    std::cout << "                          - Generate candidates in parallel until one meets the target (auto-saves);\n";
+    std::cout << "                            an unreachable target runs until N candidates (default 1000000)\n";
     std::cout << "  load <filename>         - Load maze from file (auto-saves)\n";
     std::cout << "  save [filename]         - Save current maze to file\n";
-    std::cout << "  find                    - Find path in current maze (A*)\n";
+    std::cout << "  find [--no-cache] [--hpa [--cluster N]] [--solver name [--seed N]]\n";
+    std::cout << "       [--landmarks K] [--selection farthest|perimeter] (alt solver)\n";
+    std::cout << "                          - Find path in current maze (A* with cached solutions, or HPA*)\n";
+    std::cout << "  find --nearest [--from R,C] - Path to the nearest of all exits, from one multi-source BFS\n";
+    std::cout << "  find --budget-ms N [--max-nodes N] [--slices K]\n";
+    std::cout << "                          - A* cut off by time or expansions and resumed up to K times;\n";
+    std::cout << "                            prints the path to the closest cell reached if unfinished\n";
+    std::cout << "  route <waypoints-file> [--threads N] - Shortest tour from entrance through every \"row col\"\n";
+    std::cout << "                            waypoint in the file to the exit\n";
+    std::cout << "  add_exit <row> <col>    - Add another exit on the border of the current maze\n";
+    std::cout << "  clear_exits             - Remove all exits but the first\n";
     std::cout << "  print                   - Print current maze\n";
-    std::cout << "  full <rows> <cols> <out> - Generate and save maze\n";
-    std::cout << "  current                 - Show current maze status\n\n";
+    std::cout << "  full <rows> <cols> <out> [--algo name] [--farthest] - Generate and save maze\n";
+    std::cout << "  current                 - Show current maze status\n";
+    std::cout << "  validate                - Check the current maze is perfect with closed borders\n";
+    std::cout << "  save_tiled <file> [--tile N] - Save current maze in tiled format\n";
+    std::cout << "  gen_tiled <rows> <cols> <file> [--algo name] [--tile N] [--seed N]\n";
+    std::cout << "                          - Stream a huge maze straight to a tiled file\n";
+    std::cout << "  load_region <file> <row> <col> <rows> <cols> [--out file]\n";
+    std::cout << "                          - Load a window of a tiled maze\n";
+    std::cout << "  find_tiled <file> [--cache-mb N] - Solve a tiled maze out of core\n";
+    std::cout << "  distances [--threads N] [--out file] - Distance from exit to every cell\n";
+    std::cout << "  analyze [--json] [--threads N] [--tiled file]\n";
+    std::cout << "                          - Dead ends, junctions, corridor lengths, solution length and diameter\n";
+    std::cout << "  export_image <file> [--scale N] [--path] [--tiled in]\n";
+    std::cout << "                          - Stream a PBM (or PGM with --path) of the current or a tiled maze\n";
+    std::cout << "  bench [gen|eller|distances|race_server|hpa|solvers|alt|route] [--rows N] [--cols N] [--threads N]\n";
+    std::cout << "        [--repeats N] [--algo name] [--sessions N] [--moves N] [--cluster N] [--queries N]\n";
+    std::cout << "        [--landmarks N] [--waypoints N]\n";
+    std::cout << "                          - Run benchmarks\n\n";
+    std::cout << "Generators (--algo):\n ";
+    for (const auto& name : course::GeneratorRegistry::instance().names()) {
+        std::cout << " " << name;
+    }
+    std::cout << "\n\n";
+    std::cout << "Solvers (find --solver, weights from --seed):\n ";
+    for (const auto& name : course::PolicySolver::names()) {
+        std::cout << " " << name;
+    }
+    std::cout << "\n\n";
     std::cout << "Race Mode Commands:\n";
     std::cout << "  race_start              - Start race mode\n";
     std::cout << "  race_reset              - Reset current race\n";
     std::cout << "  race_state              - Show current race state\n";
+    std::cout << "  race_hint               - Show optimal next move and remaining distance\n";
     std::cout << "  race_up                 - Move up\n";
     std::cout << "  race_down               - Move down\n";
     std::cout << "  race_left               - Move left\n";
-    std::cout << "  race_right              - Move right\n\n";
+    std::cout << "  race_right              - Move right\n";
+    std::cout << "  race_play [--view RxC] [--minimap]\n";
+    std::cout << "                          - Interactive race from the keyboard, redrawing only changed cells\n";
+    std::cout << "  Race commands accept --view RxC (or --view N) to draw only a window around\n";
+    std::cout << "  the player, and --minimap for a downsampled overview of the whole maze\n";
+    std::cout << "  race_loadgen [--players N] [--moves N] [--threads N] [--strategy random|wall|optimal]\n";
+    std::cout << "               [--noise P] [--mode memory|persistent] [--seed N]\n";
+    std::cout << "                          - Simulated players on the current maze, moves/s and latency\n\n";
     std::cout << "Examples:\n";
     std::cout << "  maze.exe gen 10 15\n";
     std::cout << "  maze.exe race_start\n";
@@ -38,7 +118,180 @@ void print_help() {
 }
 
 bool validate_maze_size(int rows, int cols) {
-    return rows > 0 && cols > 0 && rows <= 60 && cols <= 60;
+    return rows > 0 && cols > 0 && rows <= course::Maze::MAX_SIDE && cols <= course::Maze::MAX_SIDE;
+}
+
+// Value following a --name flag, or fallback when the flag is absent
+std::string get_option(const int argc, char **argv, const std::string& name, const std::string& fallback = "") {
+    for (int i = 2; i + 1 < argc; i++) {
+        if (argv[i] == name) {
+            return argv[i + 1];
+        }
+    }
+    return fallback;
+}
+
+bool has_flag(const int argc, char **argv, const std::string& name) {
+    for (int i = 2; i < argc; i++) {
+        if (argv[i] == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Viewport from --view RxC (or --view N for a square window) and --minimap
+course::RaceMode::Options race_options(const int argc, char **argv) {
+    course::RaceMode::Options options;
+    const std::string view = get_option(argc, argv, "--view");
+    if (!view.empty()) {
+        const size_t x = view.find('x');
+        options.viewport_rows = std::stoi(view.substr(0, x));
+        options.viewport_cols = x == std::string::npos ? options.viewport_rows : std::stoi(view.substr(x + 1));
+        if (options.viewport_rows <= 0 || options.viewport_cols <= 0) {
+            throw std::invalid_argument("Viewport must be at least 1x1");
+        }
+    }
+    options.minimap = has_flag(argc, argv, "--minimap");
+    return options;
+}
+
+// Generate a maze with the algorithm chosen by --algo (Eller by default). Rows go to the
+// files on a writer thread, to the validator in debug builds or with --validate, and
+// to the degree counter with --stats, all in the same pass that generates them. --farthest moves the entrance and exit to the
+// ends of the longest border-to-border path
+void generate_with_options(course::Maze& maze, const int rows, const int cols, const int argc, char **argv,
+                           const std::vector<std::string>& files = {}) {
+    const auto generator = course::GeneratorRegistry::instance().create(get_option(argc, argv, "--algo", "eller"));
+    const std::string seed = get_option(argc, argv, "--seed");
+    const std::uint64_t seed_value = seed.empty() ? std::random_device{}() : std::stoull(seed);
+
+    maze.set_sizes(rows, cols);
+    maze.clear_gen();
+
+    // Moving the endpoints needs the whole maze, so the files are written afterwards
+    const bool farthest = has_flag(argc, argv, "--farthest");
+    std::vector<course::TextFileSink> outputs;
+    if (!farthest) {
+        for (const auto& file : files) {
+            outputs.emplace_back(file);
+        }
+    }
+    std::vector<course::RowSink*> targets;
+    for (auto& output : outputs) {
+        targets.push_back(&output);
+    }
+    course::AsyncRowSink writer(targets);
+    course::ValidatorSink validator;
+    course::StatsSink stats;
+    std::vector<course::RowSink*> sinks = {&writer};
+
+    const bool requested = has_flag(argc, argv, "--validate");
+    if (VALIDATE_GENERATED || requested) {
+        sinks.push_back(&validator);
+    }
+    const bool with_stats = has_flag(argc, argv, "--stats");
+    if (with_stats) {
+        sinks.push_back(&stats);
+    }
+    course::run_pipeline(generator->generate_rows(maze, seed_value, std::max(1u, std::thread::hardware_concurrency())),
+                         maze.shape(), sinks);
+
+    if (VALIDATE_GENERATED || requested) {
+        const auto& report = validator.report();
+        if (requested || !report.perfect()) {
+            report.print(std::cout);
+        }
+        if (!report.perfect()) {
+            for (const auto& file : files) {
+                fs::remove(file);
+            }
+            throw std::runtime_error("Generator '" + generator->name() + "' produced an invalid maze");
+        }
+    }
+
+    if (with_stats) {
+        const auto& counts = stats.stats();
+        const auto percent = [&](const std::uint64_t count) {
+            return counts.cells ? 100.0 * static_cast<double>(count) / static_cast<double>(counts.cells) : 0.0;
+        };
+        std::cout << "Stats: " << counts.cells << " cells, " << counts.open_edges << " open edges\n" << std::fixed
+                  << std::setprecision(1) << "  Dead ends: " << counts.dead_ends << " (" << percent(counts.dead_ends)
+                  << "%), corridors: " << counts.corridors << " (" << percent(counts.corridors)
+                  << "%), junctions: " << counts.junctions << " (" << percent(counts.junctions) << "%)\n";
+    }
+
+    if (farthest) {
+        const auto [entrance, exit] = course::farthest_border_pair(maze, std::max(1u, std::thread::hardware_concurrency()));
+        maze.move_entrance_exit(entrance, exit);
+        for (const auto& file : files) {
+            maze.to_file(file);
+        }
+    }
+}
+
+int run_bench(const int argc, char **argv) {
+    course::BenchOptions options;
+    options.rows = std::stoi(get_option(argc, argv, "--rows", std::to_string(options.rows)));
+    options.cols = std::stoi(get_option(argc, argv, "--cols", std::to_string(options.cols)));
+    options.repeats = std::stoi(get_option(argc, argv, "--repeats", std::to_string(options.repeats)));
+    options.max_threads = static_cast<unsigned>(std::stoul(get_option(argc, argv, "--threads",
+        std::to_string(std::max(1u, std::thread::hardware_concurrency())))));
+    options.algo = get_option(argc, argv, "--algo", options.algo);
+    options.sessions = std::stoi(get_option(argc, argv, "--sessions", std::to_string(options.sessions)));
+    options.moves = std::stoi(get_option(argc, argv, "--moves", std::to_string(options.moves)));
+    options.cluster = std::stoi(get_option(argc, argv, "--cluster", std::to_string(options.cluster)));
+    options.queries = std::stoi(get_option(argc, argv, "--queries", std::to_string(options.queries)));
+    options.landmarks = std::stoi(get_option(argc, argv, "--landmarks", std::to_string(options.landmarks)));
+    options.waypoints = std::stoi(get_option(argc, argv, "--waypoints", std::to_string(options.waypoints)));
+
+    const std::string suite = argc >= 3 && std::string(argv[2]).find("--") != 0 ? argv[2] : "all";
+    if (options.rows <= 0 || options.cols <= 0 || options.max_threads == 0 ||
+        options.sessions <= 0 || options.moves <= 0 || options.cluster < 2 || options.queries <= 0 ||
+        options.landmarks <= 0 || options.waypoints < 0) {
+        std::cout << "Error: bench sizes and thread count must be positive\n";
+        return 1;
+    }
+
+    bool ran = false;
+    if (suite == "all" || suite == "gen") {
+        course::bench_generators(options, std::cout);
+        ran = true;
+    }
+    if (suite == "all" || suite == "eller") {
+        course::bench_eller(options, std::cout);
+        ran = true;
+    }
+    if (suite == "all" || suite == "distances") {
+        course::bench_distances(options, std::cout);
+        ran = true;
+    }
+    if (suite == "all" || suite == "race_server") {
+        course::bench_race_server(options, std::cout);
+        ran = true;
+    }
+    if (suite == "all" || suite == "hpa") {
+        course::bench_hpa(options, std::cout);
+        ran = true;
+    }
+    if (suite == "all" || suite == "solvers") {
+        course::bench_solvers(options, std::cout);
+        ran = true;
+    }
+    if (suite == "all" || suite == "alt") {
+        course::bench_alt(options, std::cout);
+        ran = true;
+    }
+    if (suite == "all" || suite == "route") {
+        course::bench_route(options, std::cout);
+        ran = true;
+    }
+
+    if (!ran) {
+        std::cout << "Error: Unknown bench suite '" << suite << "'\n";
+        return 1;
+    }
+    return 0;
 }
 
 bool load_current_maze(course::Maze& maze) {
@@ -70,6 +323,13 @@ void print_current_status(const bool maze_loaded, const course::Maze& maze) {
         std::cout << "Current maze: " << maze.getRows() << "x" << maze.getCols() << "\n";
         std::cout << "Entrance: (" << maze.get_entrance().first << ", " << maze.get_entrance().second << ")\n";
         std::cout << "Exit: (" << maze.get_exit().first << ", " << maze.get_exit().second << ")\n";
+        if (const auto exits = maze.get_exits(); exits.size() > 1) {
+            std::cout << "All exits:";
+            for (const auto& [row, col] : exits) {
+                std::cout << " (" << row << ", " << col << ")";
+            }
+            std::cout << "\n";
+        }
         std::cout << "Saved in: " << TEMP_FILE << "\n";
     } else {
         std::cout << "No maze loaded. Use 'gen' or 'load' command first.\n";
@@ -90,7 +350,10 @@ int main(const int argc, char **argv) {
 
         // Load maze for commands that need it
         if (command == "find" || command == "print" || command == "save" ||
-            command == "current" || command.find("race_") == 0) {
+            command == "add_exit" || command == "clear_exits" || command == "route" ||
+            command == "current" || command == "save_tiled" || command == "distances" || command == "validate" ||
+            ((command == "export_image" || command == "analyze") && !has_flag(argc, argv, "--tiled")) ||
+            command.find("race_") == 0) {
             maze_loaded = load_current_maze(maze);
 
             // Commands that absolutely require a loaded maze
@@ -109,8 +372,11 @@ int main(const int argc, char **argv) {
             print_current_status(maze_loaded, maze);
             return 0;
         }
+        if (command == "bench") {
+            return run_bench(argc, argv);
+        }
         if (command == "gen") {
-            if (argc != 4) {
+            if (argc < 4) {
                 std::cout << "Error: gen requires rows and cols arguments\n";
                 return 1;
             }
@@ -119,21 +385,64 @@ int main(const int argc, char **argv) {
             int cols = std::stoi(argv[3]);
 
             if (!validate_maze_size(rows, cols)) {
-                std::cout << "Error: Rows and cols must be between 1 and 60\n";
+                std::cout << "Error: Rows and cols must be between 1 and " << course::Maze::MAX_SIDE << "\n";
                 return 1;
             }
 
-            maze.set_sizes(rows, cols);
-            maze.clear_gen();
-            maze.generate_maze();
+            generate_with_options(maze, rows, cols, argc, argv, {TEMP_FILE});
 
-            if (save_current_maze(maze)) {
-                std::cout << "SUCCESS: Maze " << rows << "x" << cols << " generated and saved\n";
-                maze.print_maze();
-                return 0;
-            } else {
+            std::cout << "SUCCESS: Maze " << rows << "x" << cols << " generated and saved\n";
+            maze.print_maze();
+            return 0;
+        }
+        if (command == "gen_target") {
+            if (argc < 4) {
+                std::cout << "Error: gen_target requires rows and cols arguments\n";
                 return 1;
             }
+
+            const int rows = std::stoi(argv[2]);
+            const int cols = std::stoi(argv[3]);
+            if (!validate_maze_size(rows, cols)) {
+                std::cout << "Error: Rows and cols must be between 1 and " << course::Maze::MAX_SIDE << "\n";
+                return 1;
+            }
+
+            course::TargetOptions options;
+            options.algo = get_option(argc, argv, "--algo", options.algo);
+            options.min_path = std::stoull(get_option(argc, argv, "--min-path", "0"));
+            options.min_dead_ends = std::stod(get_option(argc, argv, "--min-dead-ends", "0"));
+            options.farthest = has_flag(argc, argv, "--farthest");
+            options.threads = static_cast<unsigned>(std::stoul(get_option(argc, argv, "--threads",
+                std::to_string(std::max(1u, std::thread::hardware_concurrency())))));
+            const std::string seed = get_option(argc, argv, "--seed");
+            options.seed = seed.empty() ? std::random_device{}() : std::stoull(seed);
+            options.max_candidates = std::stoull(get_option(argc, argv, "--max-candidates",
+                std::to_string(options.max_candidates)));
+            if (options.threads == 0 || options.max_candidates == 0) {
+                std::cout << "Error: thread and candidate counts must be positive\n";
+                return 1;
+            }
+
+            const auto result = course::generate_target(maze, rows, cols, options);
+            std::cout << std::fixed << std::setprecision(2);
+            if (!result.found) {
+                std::cout << "ERROR: No maze met the target in " << result.scored << " candidates (longest path "
+                          << result.best_path << " steps, " << result.seconds * 1e3 << " ms)\n";
+                return 1;
+            }
+            if (!save_current_maze(maze)) {
+                return 1;
+            }
+
+            std::cout << "SUCCESS: Candidate " << result.candidate << " (seed " << result.seed << ") met the target: path "
+                      << result.analysis.solution_length << " steps, "
+                      << 100.0 * static_cast<double>(result.analysis.dead_ends) / static_cast<double>(result.analysis.cells)
+                      << "% dead ends\n";
+            std::cout << result.scored << " candidates scored on " << options.threads << " threads in "
+                      << result.seconds * 1e3 << " ms\n";
+            maze.print_maze();
+            return 0;
         }
         if (command == "load") {
             if (argc != 3) {
@@ -149,6 +458,12 @@ int main(const int argc, char **argv) {
 
             maze.from_file(filename);
 
+            // Loaded mazes may be hand-edited; report problems but keep the maze
+            if (const auto report = course::validate_maze(maze); !report.perfect()) {
+                std::cout << "Warning: ";
+                report.print(std::cout);
+            }
+
             if (save_current_maze(maze)) {
                 std::cout << "SUCCESS: Maze loaded from '" << filename << "' and saved\n";
                 maze.print_maze();
@@ -170,9 +485,235 @@ int main(const int argc, char **argv) {
                 return 1;
             }
         }
+        if (command == "export_image") {
+            if (argc < 3) {
+                std::cout << "Error: export_image requires filename argument\n";
+                return 1;
+            }
+
+            const std::string filename = argv[2];
+            const int scale = std::stoi(get_option(argc, argv, "--scale", "1"));
+            const bool with_path = has_flag(argc, argv, "--path");
+            const std::string tiled = get_option(argc, argv, "--tiled");
+            const auto start_time = std::chrono::steady_clock::now();
+
+            if (!tiled.empty()) {
+                course::TiledMazeReader reader(tiled);
+                course::PathCodec path;
+                if (with_path) {
+                    course::TiledMazeReader solver_reader(tiled);
+                    course::TileCache cache(solver_reader, 64 * 1024 * 1024);
+                    path = course::TiledAstar(cache).find_path(reader.get_entrance(), reader.get_exit());
+                }
+                course::export_image(reader, filename, scale, with_path ? &path : nullptr);
+            } else {
+                course::PathCodec path;
+                if (with_path) {
+                    path = course::Astar(maze).find_path();
+                }
+                course::export_image(maze, filename, scale, with_path ? &path : nullptr);
+            }
+
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+            std::cout << "SUCCESS: Image written to '" << filename << "' (" << fs::file_size(filename)
+                      << " bytes, " << std::fixed << std::setprecision(2) << elapsed.count() << " sec)\n";
+            return 0;
+        }
+        if (command == "analyze") {
+            const unsigned threads = static_cast<unsigned>(std::stoul(get_option(argc, argv, "--threads",
+                std::to_string(std::max(1u, std::thread::hardware_concurrency())))));
+            const std::string tiled = get_option(argc, argv, "--tiled");
+            const auto analysis = tiled.empty() ? course::analyze_maze(maze, threads)
+                                                : course::analyze_tiled(tiled, threads);
+            if (has_flag(argc, argv, "--json")) {
+                analysis.print_json(std::cout);
+            } else {
+                analysis.print(std::cout);
+            }
+            return 0;
+        }
+        if (command == "validate") {
+            const auto report = course::validate_maze(maze);
+            report.print(std::cout);
+            return report.perfect() ? 0 : 1;
+        }
+        if (command == "route") {
+            if (argc < 3) {
+                std::cout << "Error: route requires waypoints filename argument\n";
+                return 1;
+            }
+
+            const unsigned threads = static_cast<unsigned>(std::stoul(get_option(argc, argv, "--threads",
+                std::to_string(std::max(1u, std::thread::hardware_concurrency())))));
+            const auto route = course::plan_route(maze, course::read_waypoints(argv[2]), threads);
+            course::Astar(maze).print_path(route.path);
+
+            std::cout << "Route: " << route.order.size() << " waypoints, " << route.length << " steps\n";
+            for (size_t i = 1; i + 1 < route.stops.size(); i++) {
+                std::cout << "  " << i << ". (" << route.stops[i].first << ", " << route.stops[i].second << ")\n";
+            }
+            std::cout << std::fixed << std::setprecision(2) << "Distance matrix " << route.stops.size() << "x"
+                      << route.stops.size() << " in " << route.matrix_seconds * 1e3 << " ms on " << threads
+                      << " threads, " << (route.exact ? "exact" : "2-opt") << " order in "
+                      << route.order_seconds * 1e3 << " ms\n";
+            return 0;
+        }
+        if (command == "add_exit") {
+            if (argc < 4) {
+                std::cout << "Error: add_exit requires row and col arguments\n";
+                return 1;
+            }
+
+            const int row = std::stoi(argv[2]);
+            const int col = std::stoi(argv[3]);
+            if (row != 0 && col != 0 && row != maze.getRows() - 1 && col != maze.getCols() - 1) {
+                std::cout << "Error: Exits must be on the border of the maze\n";
+                return 1;
+            }
+            if (!maze.add_exit(row, col)) {
+                std::cout << "Error: (" << row << ", " << col << ") is outside the maze or already an exit\n";
+                return 1;
+            }
+            if (!save_current_maze(maze)) {
+                return 1;
+            }
+            std::cout << "SUCCESS: Exit added at (" << row << ", " << col << "), " << maze.get_exits().size()
+                      << " exits\n";
+            return 0;
+        }
+        if (command == "clear_exits") {
+            maze.clear_extra_exits();
+            if (!save_current_maze(maze)) {
+                return 1;
+            }
+            std::cout << "SUCCESS: Only the exit at (" << maze.get_exit().first << ", " << maze.get_exit().second
+                      << ") is left\n";
+            return 0;
+        }
         if (command == "find") {
             course::Astar astar(maze);
+
+            // One BFS from every exit at once labels each cell with its nearest exit
+            if (has_flag(argc, argv, "--nearest")) {
+                auto from = maze.get_entrance();
+                if (const std::string cell = get_option(argc, argv, "--from"); !cell.empty()) {
+                    const auto comma = cell.find(',');
+                    if (comma == std::string::npos) {
+                        throw std::invalid_argument("--from expects R,C");
+                    }
+                    from = {std::stoi(cell.substr(0, comma)), std::stoi(cell.substr(comma + 1))};
+                }
+
+                const auto exits = maze.get_exits();
+                const auto start_time = std::chrono::steady_clock::now();
+                const auto field = course::DistanceField::compute(maze, exits,
+                                                                  std::max(1u, std::thread::hardware_concurrency()));
+                const auto path = field.path_from(maze, from);
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+                if (path.empty()) {
+                    std::cout << "ERROR: No exit reachable from (" << from.first << ", " << from.second << ")\n";
+                    return 1;
+                }
+
+                astar.print_path(path);
+                const auto [row, col] = exits[field.nearest(from.first, from.second)];
+                std::cout << "Nearest exit: (" << row << ", " << col << "), " << field.at(from.first, from.second)
+                          << " steps; one pass over " << exits.size() << " exits in " << std::fixed
+                          << std::setprecision(2) << elapsed.count() * 1e3 << " ms\n";
+                return 0;
+            }
+
+            if (has_flag(argc, argv, "--hpa")) {
+                const int cluster = std::stoi(get_option(argc, argv, "--cluster", "16"));
+                const course::HpaGraph graph(maze, cluster, std::max(1u, std::thread::hardware_concurrency()));
+                course::HpaGraph::QueryStats stats;
+                const auto path = graph.find_path(&stats);
+                if (path.empty()) {
+                    std::cout << "ERROR: No path found!\n";
+                    return 1;
+                }
+                astar.print_path(path);
+                std::cout << "HPA*: " << graph.build_stats().clusters << " clusters, "
+                          << graph.build_stats().nodes << " abstract nodes, "
+                          << stats.abstract_expanded << " expanded, "
+                          << stats.cells_expanded << " cells refined\n";
+                return 0;
+            }
+
+            const std::string solver = get_option(argc, argv, "--solver");
+            if (!solver.empty()) {
+                const std::string seed = get_option(argc, argv, "--seed", "1");
+                course::PolicySolver policy(maze, std::stoull(seed));
+                if (solver == "alt") {
+                    policy.use_landmarks(std::stoi(get_option(argc, argv, "--landmarks", "8")),
+                                         std::max(1u, std::thread::hardware_concurrency()),
+                                         course::Landmarks::parse_selection(get_option(argc, argv, "--selection", "farthest")));
+                }
+                const auto result = policy.solve(solver, maze.get_entrance(), maze.get_exit());
+                if (result.path.empty()) {
+                    std::cout << "ERROR: No path found!\n";
+                    return 1;
+                }
+                astar.print_path(result.path);
+                std::cout << "Solver " << solver << ": cost " << result.cost << ", "
+                          << result.expanded << " cells expanded\n";
+                return 0;
+            }
+
+            // Bounded slices of one resumable search; an unfinished search still answers
+            // with the path to the cell that got closest to the exit
+            const std::string budget_ms = get_option(argc, argv, "--budget-ms");
+            const std::string max_nodes = get_option(argc, argv, "--max-nodes");
+            if (!budget_ms.empty() || !max_nodes.empty()) {
+                course::AnytimeSolver solver(maze, maze.get_entrance(), maze.get_exit());
+                const int slices = std::max(1, std::stoi(get_option(argc, argv, "--slices", "1")));
+                course::AnytimeResult result;
+                int used = 0;
+                while (used < slices && !solver.finished()) {
+                    auto budget = budget_ms.empty() ? course::SearchBudget{}
+                                                    : course::SearchBudget::within(std::chrono::milliseconds(std::stoll(budget_ms)));
+                    if (!max_nodes.empty()) budget.max_expansions = std::stoull(max_nodes);
+                    result = solver.run(budget);
+                    used++;
+                    std::cout << "Slice " << used << ": " << course::status_name(result.status) << ", "
+                              << result.expanded << " expanded, closest (" << result.closest.first << ", "
+                              << result.closest.second << ") at distance " << result.closest_distance << "\n";
+                }
+
+                if (result.status == course::AnytimeResult::Status::Unreachable) {
+                    std::cout << "ERROR: No path found!\n";
+                    return 1;
+                }
+                astar.print_path(result.path);
+                if (result.status == course::AnytimeResult::Status::Found) {
+                    std::cout << "Path of " << result.path.size() - 1 << " steps after " << used << " slices, "
+                              << result.total_expanded << " cells expanded\n";
+                } else {
+                    std::cout << "Partial path to (" << result.closest.first << ", " << result.closest.second
+                              << "), " << result.closest_distance << " from the exit; full path at least "
+                              << result.lower_bound << " steps, " << result.total_expanded << " cells expanded\n";
+                }
+                return 0;
+            }
+
+            // Repeated solves of the same maze cost a hash and a lookup
+            const bool use_cache = !has_flag(argc, argv, "--no-cache");
+            course::SolutionCache cache;
+            const auto key = course::SolutionCache::key_of(maze);
+            if (use_cache) {
+                if (const auto cached = cache.find(key)) {
+                    astar.print_path(cached->path);
+                    std::cout << "Solution from cache (maze hash " << std::hex << key.maze_hash << std::dec << ")\n";
+                    return 0;
+                }
+            }
+
+            const auto start = std::chrono::steady_clock::now();
             auto path = astar.find_path();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (use_cache && !path.empty()) {
+                cache.store(key, path, elapsed.count());
+            }
 
             if (!path.empty()) {
                 astar.print_path(path);
@@ -182,12 +723,123 @@ int main(const int argc, char **argv) {
                 return 1;
             }
         }
+        if (command == "save_tiled") {
+            if (argc < 3) {
+                std::cout << "Error: save_tiled requires filename argument\n";
+                return 1;
+            }
+
+            course::save_tiled(maze, argv[2], std::stoi(get_option(argc, argv, "--tile", "256")));
+            std::cout << "SUCCESS: Maze saved in tiled format to '" << argv[2] << "'\n";
+            return 0;
+        }
+        if (command == "gen_tiled") {
+            if (argc < 5) {
+                std::cout << "Error: gen_tiled requires rows, cols and output filename\n";
+                return 1;
+            }
+
+            const int rows = std::stoi(argv[2]);
+            const int cols = std::stoi(argv[3]);
+            const std::string filename = argv[4];
+            const auto generator = course::GeneratorRegistry::instance().create(
+                get_option(argc, argv, "--algo", "sidewinder"));
+            const std::string seed = get_option(argc, argv, "--seed");
+
+            course::generate_tiled(*generator, rows, cols,
+                                   seed.empty() ? std::random_device{}() : std::stoull(seed),
+                                   filename, std::stoi(get_option(argc, argv, "--tile", "256")),
+                                   std::max(1u, std::thread::hardware_concurrency()));
+            std::cout << "SUCCESS: Streamed " << rows << "x" << cols << " " << generator->name()
+                    << " maze to '" << filename << "' (" << fs::file_size(filename) << " bytes)\n";
+            return 0;
+        }
+        if (command == "load_region") {
+            if (argc < 7) {
+                std::cout << "Error: load_region requires filename, row, col, rows and cols\n";
+                return 1;
+            }
+
+            course::TiledMazeReader reader(argv[2]);
+            reader.load_region(maze, std::stoi(argv[3]), std::stoi(argv[4]), std::stoi(argv[5]), std::stoi(argv[6]));
+
+            std::cout << "Region " << maze.getRows() << "x" << maze.getCols() << " of "
+                    << reader.getRows() << "x" << reader.getCols() << " maze\n";
+            std::cout << "Tiles read: " << reader.tiles_read() << " of "
+                    << static_cast<long long>(reader.tiles_x()) * reader.tiles_y()
+                    << ", bytes read: " << reader.bytes_read() << " of " << fs::file_size(argv[2]) << "\n";
+
+            if (const std::string out = get_option(argc, argv, "--out"); !out.empty()) {
+                if (!save_current_maze(maze, out)) {
+                    return 1;
+                }
+                std::cout << "SUCCESS: Region saved to '" << out << "'\n";
+            }
+            maze.print_maze();
+            return 0;
+        }
+        if (command == "find_tiled") {
+            if (argc < 3) {
+                std::cout << "Error: find_tiled requires filename argument\n";
+                return 1;
+            }
+
+            const double cache_mb = std::stod(get_option(argc, argv, "--cache-mb", "64"));
+            course::TiledMazeReader reader(argv[2]);
+            course::TileCache cache(reader, static_cast<size_t>(cache_mb * 1024 * 1024));
+            course::TiledAstar solver(cache);
+
+            const auto start_time = std::chrono::steady_clock::now();
+            const auto path = solver.find_path(reader.get_entrance(), reader.get_exit());
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+            const auto cache_stats = cache.stats();
+            const auto& search_stats = solver.stats();
+            std::cout << "Maze: " << reader.getRows() << "x" << reader.getCols()
+                    << ", file " << fs::file_size(argv[2]) << " bytes, cache budget "
+                    << cache.capacity() << " bytes\n";
+            std::cout << "Cache: " << cache_stats.hits << " hits, " << cache_stats.misses << " misses, "
+                    << cache_stats.evictions << " evictions, hit rate "
+                    << std::fixed << std::setprecision(2) << cache_stats.hit_rate() * 100.0 << "%\n";
+            std::cout << "Bytes read: " << cache_stats.bytes_read << ", peak cache: " << cache_stats.peak_bytes << "\n";
+            std::cout << "Search: " << search_stats.expanded << " expanded, peak open " << search_stats.peak_open
+                    << ", state " << search_stats.state_bytes << " bytes in " << search_stats.state_tiles << " tiles\n";
+            std::cout << "Time: " << std::setprecision(3) << elapsed.count() << " sec\n";
+
+            if (path.empty()) {
+                std::cout << "ERROR: No path found!\n";
+                return 1;
+            }
+            std::cout << "Path length: " << path.size() - 1 << " steps\n";
+            return 0;
+        }
+        if (command == "distances") {
+            const unsigned threads = static_cast<unsigned>(std::stoul(get_option(argc, argv, "--threads",
+                std::to_string(std::max(1u, std::thread::hardware_concurrency())))));
+            const std::string out = get_option(argc, argv, "--out", DISTANCE_FILE);
+
+            const auto start_time = std::chrono::steady_clock::now();
+            const auto field = course::DistanceField::compute(maze, maze.get_exit(), threads);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+            field.to_file(out, maze.content_hash());
+
+            const auto entrance = maze.get_entrance();
+            std::cout << "Distance field from exit (" << maze.get_exit().first << ", " << maze.get_exit().second << ")\n";
+            std::cout << "  Reached cells: " << field.stats().reached << " of "
+                    << static_cast<long long>(maze.getRows()) * maze.getCols() << "\n";
+            std::cout << "  Farthest cell: " << field.max_distance() << " steps\n";
+            std::cout << "  Entrance: " << field.at(entrance.first, entrance.second) << " steps\n";
+            std::cout << "  Levels: " << field.stats().levels << ", threads: " << threads << "\n";
+            std::cout << "  Time: " << std::fixed << std::setprecision(6) << elapsed.count() << " sec\n";
+            std::cout << "SUCCESS: Distances saved to '" << out << "'\n";
+            return 0;
+        }
         if (command == "print") {
             maze.print_maze();
             return 0;
         }
         if (command == "full") {
-            if (argc != 5) {
+            if (argc < 5) {
                 std::cout << "Error: full requires rows, cols and output filename\n";
                 return 1;
             }
@@ -197,27 +849,68 @@ int main(const int argc, char **argv) {
             const std::string filename = argv[4];
 
             if (!validate_maze_size(rows, cols)) {
-                std::cout << "Error: Rows and cols must be between 1 and 60\n";
+                std::cout << "Error: Rows and cols must be between 1 and " << course::Maze::MAX_SIDE << "\n";
                 return 1;
             }
 
-            maze.set_sizes(rows, cols);
-            maze.clear_gen();
-            maze.generate_maze();
+            generate_with_options(maze, rows, cols, argc, argv, {filename, TEMP_FILE});
 
-            if (save_current_maze(maze, filename) && save_current_maze(maze)) {
-                std::cout << "SUCCESS: Generated " << rows << "x" << cols
-                        << " maze and saved to '" << filename << "'\n";
-                maze.print_maze();
+            std::cout << "SUCCESS: Generated " << rows << "x" << cols
+                    << " maze and saved to '" << filename << "'\n";
+            maze.print_maze();
+            return 0;
+        }
+
+        // Load test runs its own races and leaves the current one alone
+        if (command == "race_loadgen") {
+            course::LoadgenOptions options;
+            options.players = std::stoi(get_option(argc, argv, "--players", std::to_string(options.players)));
+            options.moves = std::stoi(get_option(argc, argv, "--moves", std::to_string(options.moves)));
+            options.threads = static_cast<unsigned>(std::stoul(get_option(argc, argv, "--threads",
+                std::to_string(std::max(1u, std::thread::hardware_concurrency())))));
+            options.strategy = course::LoadgenOptions::parse_strategy(get_option(argc, argv, "--strategy", "random"));
+            options.noise = std::stod(get_option(argc, argv, "--noise", std::to_string(options.noise)));
+            options.mode = course::LoadgenOptions::parse_mode(get_option(argc, argv, "--mode", "memory"));
+            options.seed = std::stoull(get_option(argc, argv, "--seed", std::to_string(options.seed)));
+
+            course::run_loadgen(maze, options).print(options, std::cout);
+            return 0;
+        }
+
+        // Interactive race in its own terminal session; the file-based race is left alone
+        if (command == "race_play") {
+            auto options = race_options(argc, argv);
+            if (options.viewport_rows == 0) {
+                // Fit the window to the terminal, leaving room for the status lines
+                const auto [term_rows, term_cols] = course::RawTerminal::size();
+                options.viewport_rows = std::max(1, (term_rows - 5) / 2);
+                options.viewport_cols = std::max(1, (term_cols - 2) / 4);
+            }
+            options.persistent = false;
+            options.out = nullptr;
+            options.hints = std::make_shared<const course::DistanceField>(
+                course::DistanceField::compute(maze, maze.get_exit()));
+
+            course::RaceMode race(maze, options);
+            race.start_race();
+            const bool finished = course::play_race(race, std::cout);
+
+            race.set_output(&std::cout);
+            if (!finished) {
+                std::cout << "Race abandoned after " << race.get_player_stats().moves << " moves.\n";
                 return 0;
             }
-            return 1;
+            std::cout << "You reached the exit in " << race.get_player_stats().moves << " moves ("
+                      << std::fixed << std::setprecision(2) << race.get_elapsed_time() << " s)\n\n";
+            race.print_comparison();
+            race.save_results_to_file(RACE_RESULTS_FILE);
+            return 0;
         }
 
         // Race Mode Commands - maze must be loaded at this point
         if (command.find("race_") == 0) {
             // Create race mode instance
-            course::RaceMode race(maze);
+            course::RaceMode race(maze, race_options(argc, argv));
 
             if (command == "race_start") {
                 race.start_race();
@@ -248,6 +941,15 @@ int main(const int argc, char **argv) {
                 return 0;
             }
 
+            if (command == "race_hint") {
+                if (race_active) {
+                    race.print_hint();
+                } else {
+                    std::cout << "No active race. Use 'race_start' to begin.\n";
+                }
+                return 0;
+            }
+
             // Movement commands require active race
             if (!race_active) {
                 std::cout << "ERROR: No active race! Use 'race_start' first.\n";
@@ -255,24 +957,20 @@ int main(const int argc, char **argv) {
             }
 
             // Load race state and continue
-            bool moved = false;
+            // Moves print the new state themselves
             if (command == "race_up") {
-                moved = race.move_up();
+                race.move_up();
             } else if (command == "race_down") {
-                moved = race.move_down();
+                race.move_down();
             } else if (command == "race_left") {
-                moved = race.move_left();
+                race.move_left();
             } else if (command == "race_right") {
-                moved = race.move_right();
+                race.move_right();
             } else {
                 std::cout << "Unknown race command: " << command << "\n";
                 return 1;
             }
 
-            if (moved) {
-                race.print_current_state();
-            }
-
             // Check if race finished
             if (race.is_race_finished()) {
                 if (fs::exists("race_active.tmp")) {
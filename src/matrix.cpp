@@ -25,6 +25,8 @@ namespace course {
 
     bool &Matrix::operator()(const int row, const int col) { return matrix_[row][col]; }
 
+    bool Matrix::operator()(const int row, const int col) const { return matrix_[row][col]; }
+
     Matrix::~Matrix() {
         deallocate();
     }
@@ -2,9 +2,12 @@
 // Created by IWOFLEUR on 04.12.2025.
 //
 
+#include <algorithm>
 #include <iostream>
 #include <maze.h>
+#include <rowpipeline.h>
 #include <random>
+#include <sstream>
 
 namespace course {
     void Maze::clear_gen() {
@@ -12,13 +15,7 @@ namespace course {
         counter_ = 1;
         entrance_ = {0, 0};
         exit_ = {rows_ - 1, cols_ - 1};
-    }
-
-    bool Maze::get_random_bool() {
-        std::random_device rd;
-        std::default_random_engine rng(rd());
-        std::uniform_int_distribution<int> dist(0, 1);
-        return static_cast<bool>(dist(rng));
+        extraExits_.clear();
     }
 
     // Merge cells into one set
@@ -62,7 +59,7 @@ namespace course {
             }
 
             // Random choice or cells already in same set
-            if (const auto choice = get_random_bool(); choice == true || sideLine_[i] == sideLine_[i + 1])
+            if (const auto choice = rowBits_.right_bit(i); choice == true || sideLine_[i] == sideLine_[i + 1])
                 vWalls_(row, i) = true;
             else
                 // Merge cells into same subset
@@ -87,7 +84,7 @@ namespace course {
             }
 
             // Only add wall if set has more than one cell
-            if (const auto choice = get_random_bool(); calc_unique_set(sideLine_[i]) != 1 && choice == true)
+            if (const auto choice = rowBits_.down_bit(i); calc_unique_set(sideLine_[i]) != 1 && choice == true)
                 hWalls_(row, i) = true;
             else
                 hWalls_(row, i) = false;
@@ -186,11 +183,18 @@ namespace course {
 
     // Main maze generation algorithm
     void Maze::generate_maze() {
+        std::random_device rd;
+        for (auto rows = generate_rows(static_cast<std::uint64_t>(rd()) << 32 | rd()); rows.next();) {}
+    }
+
+    // Later rows never touch a finished one, so it can be handed out while the next is built
+    RowStream Maze::generate_rows(const std::uint64_t seed) {
         // 1. Initialize
         fill_empty_value();
 
         // 2-5.1. Process all rows except last
         for (auto j = 0; j < rows_ - 1; j++) {
+            rowBits_.draw(seed, j, cols_);
             // 2. Assign unique sets
             assign_unique_set();
             // 3. Add vertical walls
@@ -200,47 +204,109 @@ namespace course {
             check_horizontal_walls(j);
             // 5.1. Prepare next line
             prepare_new_line(j);
+
+            // Open entrance and exit by removing boundary walls
+            open_entrance_exit(j);
+            co_yield WallRow{j, cols_, vWalls_.row(j), hWalls_.row(j)};
         }
 
         // 5.2. Process last row
+        rowBits_.draw(seed, rows_ - 1, cols_);
         add_end_line();
         check_end_line();
+        open_entrance_exit(rows_ - 1);
+        co_yield WallRow{rows_ - 1, cols_, vWalls_.row(rows_ - 1), hWalls_.row(rows_ - 1)};
+    }
 
-        // Open entrance and exit by removing boundary walls
-        open_entrance_exit();
+    RowStream Maze::rows() const {
+        for (auto i = 0; i < rows_; i++)
+            co_yield WallRow{i, cols_, vWalls_.row(i), hWalls_.row(i)};
     }
 
-    // Open entrance and exit on maze boundaries
+    // Open entrance and exit on maze boundaries.
+    // Only the stored bottom and right borders are touched; passages inside the maze are
+    // left to the generator so that opening the boundary never introduces a cycle.
+    // Top and left borders have no wall storage and are always drawn open.
     void Maze::open_entrance_exit() {
-        // Open entrance
-        if (entrance_.first == 0) {
-            // Top boundary - remove horizontal wall above
-            hWalls_(0, entrance_.second) = false;
-        } else if (entrance_.first == rows_ - 1) {
-            // Bottom boundary - remove horizontal wall below
-            hWalls_(rows_ - 1, entrance_.second) = false;
-        }
+        open_endpoint(entrance_.first, entrance_.second);
+        open_endpoint(exit_.first, exit_.second);
+        for (const auto& [row, col] : extraExits_)
+            open_endpoint(row, col);
+    }
 
-        if (entrance_.second == cols_ - 1 && entrance_.first > 0 && entrance_.first < rows_ - 1) {
-            // Right boundary (not corner) - remove vertical wall to the left
-            vWalls_(entrance_.first, entrance_.second - 1) = false;
-        }
-        // Note: Left boundary (entrance_.second == 0) needs no wall removal as there's no internal wall
+    // Endpoints in one row only; the walls touched all belong to that row
+    void Maze::open_entrance_exit(const int row) {
+        if (entrance_.first == row) open_endpoint(row, entrance_.second);
+        if (exit_.first == row) open_endpoint(row, exit_.second);
+        for (const auto& [endRow, col] : extraExits_)
+            if (endRow == row) open_endpoint(row, col);
+    }
 
-        // Open exit
-        if (exit_.first == 0) {
-            // Top boundary - remove horizontal wall above
-            hWalls_(0, exit_.second) = false;
-        } else if (exit_.first == rows_ - 1) {
+    void Maze::open_endpoint(const int row, const int col) {
+        if (row == rows_ - 1) {
             // Bottom boundary - remove horizontal wall below
-            hWalls_(rows_ - 1, exit_.second) = false;
+            hWalls_(rows_ - 1, col) = false;
+        } else if (col == cols_ - 1 && row > 0) {
+            // Right boundary (not corner) - remove vertical wall on the border
+            vWalls_(row, cols_ - 1) = false;
         }
+    }
 
-        if (exit_.second == cols_ - 1 && exit_.first > 0 && exit_.first < rows_ - 1) {
-            // Right boundary (not corner) - remove vertical wall to the left
-            vWalls_(exit_.first, exit_.second - 1) = false;
-        }
-        // Note: Left boundary (exit_.second == 0) needs no wall removal as there's no internal wall
+    // Stored bottom and right borders, before the endpoints are opened again
+    void Maze::close_border() {
+        for (int j = 0; j < cols_; j++)
+            hWalls_(rows_ - 1, j) = true;
+        for (int i = 0; i < rows_; i++)
+            vWalls_(i, cols_ - 1) = true;
+    }
+
+    void Maze::move_entrance_exit(const std::pair<int, int> entrance, const std::pair<int, int> exit) {
+        close_border();
+        set_entrance(entrance.first, entrance.second);
+        set_exit(exit.first, exit.second);
+        open_entrance_exit();
+    }
+
+    std::vector<std::pair<int, int>> Maze::get_exits() const {
+        std::vector<std::pair<int, int>> exits = {exit_};
+        exits.insert(exits.end(), extraExits_.begin(), extraExits_.end());
+        return exits;
+    }
+
+    bool Maze::is_exit(const int row, const int col) const {
+        return exit_ == std::pair{row, col} || std::ranges::find(extraExits_, std::pair{row, col}) != extraExits_.end();
+    }
+
+    bool Maze::add_exit(const int row, const int col) {
+        if (row < 0 || row >= rows_ || col < 0 || col >= cols_ || is_exit(row, col)) return false;
+        extraExits_.emplace_back(row, col);
+        open_endpoint(row, col);
+        return true;
+    }
+
+    void Maze::clear_extra_exits() {
+        extraExits_.clear();
+        close_border();
+        open_entrance_exit();
+    }
+
+    std::string endpoint_lines(const MazeShape& shape) {
+        if (shape.entrance == std::pair{0, 0} && shape.exit == std::pair{shape.rows - 1, shape.cols - 1} &&
+            shape.extra_exits.empty())
+            return "";
+
+        std::string lines = "\nentrance " + std::to_string(shape.entrance.first) + " " +
+                            std::to_string(shape.entrance.second) + "\n";
+        lines += "exit " + std::to_string(shape.exit.first) + " " + std::to_string(shape.exit.second) + "\n";
+        for (const auto& [row, col] : shape.extra_exits)
+            lines += "exit " + std::to_string(row) + " " + std::to_string(col) + "\n";
+        return lines;
+    }
+
+    std::uint64_t Maze::content_hash() const {
+        HashSink hasher;
+        run_pipeline(rows(), shape(), {&hasher});
+        return hasher.value();
     }
 
     void Maze::set_entrance(int row, int col) {
@@ -261,6 +327,7 @@ namespace course {
         allocate_walls();
         entrance_ = {0, 0};
         exit_ = {rows_ - 1, cols_ - 1};
+        extraExits_.clear();
     }
 
     inline void Maze::allocate_walls() {
@@ -274,7 +341,7 @@ namespace course {
         size_t subPos = 0;
         rows_ = std::stoi(line, &subPos);
         cols_ = std::stoi(line.substr(subPos));
-        if ((rows_ < 0 || rows_ > 60) || (cols_ < 0 || cols_ > 60))
+        if ((rows_ < 0 || rows_ > MAX_SIDE) || (cols_ < 0 || cols_ > MAX_SIDE))
             throw std::invalid_argument("Wrong maze size");
         entrance_ = {0, 0};
         exit_ = {rows_ - 1, cols_ - 1};
@@ -289,6 +356,34 @@ namespace course {
         }
     }
 
+    // Optional "entrance r c" / "exit r c" lines, the first exit being the main one;
+    // the walls already carry their openings
+    void Maze::parse_endpoints() {
+        extraExits_.clear();
+        bool firstExit = true;
+        std::string line;
+        while (std::getline(mazeFile_, line)) {
+            std::istringstream words(line);
+            std::string key;
+            if (!(words >> key)) continue;
+
+            int row = -1, col = -1;
+            words >> row >> col;
+            if (key != "entrance" && key != "exit")
+                throw std::invalid_argument("Unknown line in maze file: " + line);
+            if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+                throw std::invalid_argument("Maze " + key + " outside the maze: " + line);
+            if (key == "entrance") {
+                entrance_ = {row, col};
+            } else if (firstExit) {
+                exit_ = {row, col};
+                firstExit = false;
+            } else if (!is_exit(row, col)) {
+                extraExits_.emplace_back(row, col);
+            }
+        }
+    }
+
     void Maze::from_file(const std::string& filename) {
         mazeFile_ = std::ifstream(filename);
         if (!mazeFile_.is_open()) {
@@ -302,17 +397,25 @@ namespace course {
         std::getline(mazeFile_, line);
 
         parse_walls(hWalls_);
+        parse_endpoints();
         mazeFile_.close();
     }
 
     void Maze::print_maze() {
         std::cout << "\n";
+        if (cols_ > PRINT_MAX_COLS) {
+            std::cout << "Maze " << rows_ << "x" << cols_ << " is too wide to print (over "
+                      << PRINT_MAX_COLS << " columns)\n";
+            return;
+        }
 
         // Print top border
         for (int j = 0; j < cols_; j++) {
             std::cout << "+";
             if (entrance_.first == 0 && entrance_.second == j) {
                 std::cout << " E ";  // Entrance on top
+            } else if (is_exit(0, j)) {
+                std::cout << " X ";  // Exit on top
             } else {
                 std::cout << "---";
             }
@@ -322,8 +425,8 @@ namespace course {
         // Print maze rows
         for (int i = 0; i < rows_; i++) {
             // Left border
-            if (entrance_.first == i && entrance_.second == 0) {
-                std::cout << " ";  // Open entrance on left
+            if ((entrance_.first == i && entrance_.second == 0) || is_exit(i, 0)) {
+                std::cout << " ";  // Open entrance or exit on left
             } else {
                 std::cout << "|";
             }
@@ -332,7 +435,7 @@ namespace course {
             for (int j = 0; j < cols_; j++) {
                 if (entrance_.first == i && entrance_.second == j) {
                     std::cout << " E ";
-                } else if (exit_.first == i && exit_.second == j) {
+                } else if (is_exit(i, j)) {
                     std::cout << " X ";
                 } else {
                     std::cout << "   ";
@@ -346,7 +449,7 @@ namespace course {
                     }
                 } else {
                     // Right border
-                    if (exit_.first == i && exit_.second == cols_ - 1) {
+                    if (is_exit(i, cols_ - 1)) {
                         std::cout << " ";  // Open exit on right
                     } else {
                         std::cout << "|";
@@ -372,7 +475,7 @@ namespace course {
         // Print bottom border
         std::cout << "+";
         for (int j = 0; j < cols_; j++) {
-            if (exit_.first == rows_ - 1 && exit_.second == j) {
+            if (is_exit(rows_ - 1, j)) {
                 std::cout << " X +";  // Exit on bottom
             } else {
                 std::cout << "---+";
@@ -405,6 +508,7 @@ namespace course {
             }
             file << std::endl;
         }
+        file << endpoint_lines(shape());
 
         file.close();
     }
@@ -0,0 +1,187 @@
+//
+// Compact path storage: start cell plus 2-bit moves, decoded lazily
+//
+
+#include <pathcodec.h>
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace course {
+    namespace {
+        constexpr char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        // Longest run stored in one RLE byte: 2 bits of move, 6 bits of length - 1
+        constexpr std::uint32_t MAX_RUN = 64;
+
+        std::string to_base64(const std::vector<std::uint8_t>& bytes) {
+            std::string out;
+            out.reserve((bytes.size() + 2) / 3 * 4);
+            for (size_t i = 0; i < bytes.size(); i += 3) {
+                std::uint32_t chunk = bytes[i] << 16;
+                if (i + 1 < bytes.size()) chunk |= bytes[i + 1] << 8;
+                if (i + 2 < bytes.size()) chunk |= bytes[i + 2];
+                out += BASE64[chunk >> 18 & 63];
+                out += BASE64[chunk >> 12 & 63];
+                out += i + 1 < bytes.size() ? BASE64[chunk >> 6 & 63] : '=';
+                out += i + 2 < bytes.size() ? BASE64[chunk & 63] : '=';
+            }
+            return out;
+        }
+
+        std::vector<std::uint8_t> from_base64(const std::string& text) {
+            auto value = [](const char c) -> int {
+                if (c >= 'A' && c <= 'Z') return c - 'A';
+                if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+                if (c >= '0' && c <= '9') return c - '0' + 52;
+                if (c == '+') return 62;
+                if (c == '/') return 63;
+                throw std::invalid_argument("Invalid base64 path data");
+            };
+
+            if (text.size() % 4 != 0) throw std::invalid_argument("Invalid base64 path data");
+            std::vector<std::uint8_t> out;
+            out.reserve(text.size() / 4 * 3);
+            for (size_t i = 0; i < text.size(); i += 4) {
+                std::uint32_t chunk = value(text[i]) << 18 | value(text[i + 1]) << 12;
+                if (text[i + 2] != '=') chunk |= value(text[i + 2]) << 6;
+                if (text[i + 3] != '=') chunk |= value(text[i + 3]);
+                out.push_back(static_cast<std::uint8_t>(chunk >> 16));
+                if (text[i + 2] != '=') out.push_back(static_cast<std::uint8_t>(chunk >> 8));
+                if (text[i + 3] != '=') out.push_back(static_cast<std::uint8_t>(chunk));
+            }
+            return out;
+        }
+    }
+
+    PathCodec::const_iterator& PathCodec::const_iterator::operator++() {
+        if (index_ + 1 < codec_->count_)
+            cell_ = apply(cell_, codec_->move_at(index_));
+        index_++;
+        return *this;
+    }
+
+    PathCodec::PathCodec(const std::vector<std::pair<int, int>>& cells) {
+        moves_.reserve(cells.size() / 32 + 1);
+        for (const auto& cell : cells)
+            push_back(cell);
+    }
+
+    std::pair<int, int> PathCodec::apply(const std::pair<int, int>& cell, const Move move) {
+        switch (move) {
+            case Up: return {cell.first - 1, cell.second};
+            case Down: return {cell.first + 1, cell.second};
+            case Left: return {cell.first, cell.second - 1};
+            default: return {cell.first, cell.second + 1};
+        }
+    }
+
+    void PathCodec::push_back(const std::pair<int, int>& cell) {
+        if (count_ == 0) {
+            start_ = end_ = cell;
+            count_ = 1;
+            return;
+        }
+
+        const int dr = cell.first - end_.first;
+        const int dc = cell.second - end_.second;
+        if (dr == -1 && dc == 0) push_move(Up);
+        else if (dr == 1 && dc == 0) push_move(Down);
+        else if (dr == 0 && dc == -1) push_move(Left);
+        else if (dr == 0 && dc == 1) push_move(Right);
+        else throw std::invalid_argument("Path cells must be adjacent");
+    }
+
+    void PathCodec::push_move(const Move move) {
+        if (count_ == 0) throw std::logic_error("Path needs a start cell before moves");
+
+        const size_t i = count_ - 1;
+        if ((i & 31) == 0) moves_.push_back(0);
+        moves_[i >> 5] |= static_cast<std::uint64_t>(move) << ((i & 31) * 2);
+        end_ = apply(end_, move);
+        count_++;
+    }
+
+    void PathCodec::clear() {
+        start_ = end_ = {-1, -1};
+        count_ = 0;
+        moves_.clear();
+    }
+
+    std::vector<std::pair<int, int>> PathCodec::decode() const {
+        return {begin(), end()};
+    }
+
+    std::vector<std::pair<PathCodec::Move, std::uint32_t>> PathCodec::runs() const {
+        std::vector<std::pair<Move, std::uint32_t>> result;
+        for (size_t i = 0; i + 1 < count_; i++) {
+            const Move move = move_at(i);
+            if (!result.empty() && result.back().first == move)
+                result.back().second++;
+            else
+                result.emplace_back(move, 1);
+        }
+        return result;
+    }
+
+    void PathCodec::write(std::ostream& out) const {
+        out << count_ << " " << start_.first << " " << start_.second;
+        if (count_ <= 1) {
+            out << " P -";
+            return;
+        }
+
+        // Packed: 4 moves per byte
+        std::vector<std::uint8_t> packed((count_ - 1 + 3) / 4, 0);
+        for (size_t i = 0; i + 1 < count_; i++)
+            packed[i >> 2] |= static_cast<std::uint8_t>(move_at(i) << ((i & 3) * 2));
+
+        // Run-length: one byte per straight segment of up to MAX_RUN moves
+        std::vector<std::uint8_t> rle;
+        for (auto [move, length] : runs()) {
+            while (length > 0) {
+                const std::uint32_t chunk = std::min(length, MAX_RUN);
+                rle.push_back(static_cast<std::uint8_t>(move | (chunk - 1) << 2));
+                length -= chunk;
+            }
+        }
+
+        if (rle.size() < packed.size())
+            out << " R " << to_base64(rle);
+        else
+            out << " P " << to_base64(packed);
+    }
+
+    void PathCodec::read(std::istream& in) {
+        size_t count;
+        std::pair<int, int> start;
+        std::string method, payload;
+        if (!(in >> count >> start.first >> start.second >> method >> payload)) {
+            throw std::invalid_argument("Invalid path record");
+        }
+
+        clear();
+        if (count == 0) return;
+        push_back(start);
+        if (count == 1) return;
+
+        const auto bytes = from_base64(payload);
+        if (method == "R") {
+            for (const std::uint8_t byte : bytes)
+                for (int k = 0; k <= byte >> 2; k++)
+                    push_move(static_cast<Move>(byte & 3));
+        } else {
+            for (size_t i = 0; i + 1 < count && i / 4 < bytes.size(); i++)
+                push_move(static_cast<Move>(bytes[i >> 2] >> ((i & 3) * 2) & 3));
+        }
+
+        if (count_ != count) {
+            throw std::invalid_argument("Path record length mismatch");
+        }
+    }
+
+    bool PathCodec::operator==(const PathCodec& other) const {
+        return count_ == other.count_ && start_ == other.start_ && moves_ == other.moves_;
+    }
+}
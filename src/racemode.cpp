@@ -3,6 +3,8 @@
 //
 
 #include "racemode.h"
+#include "distance.h"
+#include "solutioncache.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -13,9 +15,34 @@
 namespace course {
 
 const std::string RACE_STATE_FILE = "race_state.tmp";
+const std::string RACE_HINTS_FILE = "race_hints.tmp";
+
+// Messages go to the configured stream; a silent race writes into its own null stream,
+// so races on different threads never share formatting state
+std::ostream& RaceMode::out() const {
+    return options_.out ? *options_.out : null_out_;
+}
+
+// Precompute the distance-to-exit field once per race and persist it with the race
+void RaceMode::prepare_hints() const {
+    if (options_.hints || !options_.persistent) return;
+    DistanceField::compute(maze_, maze_.get_exit()).to_file(RACE_HINTS_FILE, maze_.content_hash());
+}
+
+// Cached field must belong to this very maze: same walls, same exit
+bool RaceMode::hints_match_maze() const {
+    int rows = 0, cols = 0;
+    std::pair<int, int> source;
+    std::uint64_t maze_hash = 0;
+    return DistanceField::read_header(RACE_HINTS_FILE, rows, cols, source, maze_hash) &&
+           rows == maze_.getRows() && cols == maze_.getCols() && source == maze_.get_exit() &&
+           maze_hash == maze_.content_hash();
+}
 
 // Save race state to file
 void RaceMode::save_state() const {
+    if (!options_.persistent) return;
+
     std::ofstream file(RACE_STATE_FILE);
     if (!file.is_open()) return;
 
@@ -26,11 +53,14 @@ void RaceMode::save_state() const {
     file << player_stats_.time_seconds << "\n";
     file << player_stats_.completed << "\n";
 
-    // Save path
-    file << player_stats_.path.size() << "\n";
-    for (const auto& pos : player_stats_.path) {
-        file << pos.first << " " << pos.second << "\n";
-    }
+    // Save background A* result
+    file << astar_stats_.completed << " " << astar_stats_.moves << " " << astar_stats_.time_seconds << "\n";
+    astar_stats_.path.write(file);
+    file << "\n";
+
+    // Save path (start cell and 2-bit moves)
+    player_stats_.path.write(file);
+    file << "\n";
 
     // Save start time (as seconds since epoch)
     auto duration = start_time_.time_since_epoch();
@@ -52,14 +82,16 @@ void RaceMode::load_state() {
     file >> player_stats_.time_seconds;
     file >> player_stats_.completed;
 
-    // Load path
-    size_t path_size;
-    file >> path_size;
-    player_stats_.path.clear();
-    for (size_t i = 0; i < path_size; i++) {
-        int row, col;
-        file >> row >> col;
-        player_stats_.path.emplace_back(row, col);
+    // Load background A* result and path; a state from an older format
+    // keeps empty paths so the race can still be reset
+    try {
+        file >> astar_stats_.completed >> astar_stats_.moves >> astar_stats_.time_seconds;
+        astar_stats_.path.read(file);
+        player_stats_.path.read(file);
+    } catch (const std::invalid_argument&) {
+        astar_stats_ = AStarStats();
+        player_stats_.path.clear();
+        file.clear();
     }
 
     // Load start time
@@ -70,18 +102,31 @@ void RaceMode::load_state() {
     file.close();
 }
 
-// Constructor
-RaceMode::RaceMode(Maze& maze) : maze_(maze) {
+// Constructors
+RaceMode::RaceMode(const Maze& maze) : RaceMode(maze, Options()) {}
+
+RaceMode::RaceMode(const Maze& maze, Options options) : maze_(maze), options_(std::move(options)) {
     current_position_ = maze_.get_entrance();
-    load_state(); // Try to load existing state
+    if (options_.persistent) {
+        load_state(); // Try to load existing state
+    }
+}
+
+// Never drop a background solve: store it with the race before going away
+RaceMode::~RaceMode() {
+    try {
+        collect_astar();
+    } catch (...) {
+        // Finish screen falls back to a synchronous solve
+    }
 }
 
 // Start a new race
 void RaceMode::start_race() {
     if (race_started_) {
-        std::cout << "⚠️  Race already started!\n";
-        std::cout << "Current position: (" << current_position_.first << ", " << current_position_.second << ")\n";
-        std::cout << "Moves: " << player_stats_.moves << "\n";
+        out() << "⚠️  Race already started!\n";
+        out() << "Current position: (" << current_position_.first << ", " << current_position_.second << ")\n";
+        out() << "Moves: " << player_stats_.moves << "\n";
         print_current_state();
         return;
     }
@@ -94,12 +139,20 @@ void RaceMode::start_race() {
     astar_stats_ = AStarStats();
     start_time_ = std::chrono::steady_clock::now();
 
+    // Solve in the background unless a shared or cached result exists; kept with the race state
+    if (options_.optimal.valid()) {
+        astar_task_ = options_.optimal;
+    } else if (!load_cached_optimal()) {
+        astar_task_ = std::async(std::launch::async, solve_optimal, std::cref(maze_)).share();
+    }
+
     save_state();
+    prepare_hints();
 
-    std::cout << "🏁 RACE STARTED!\n";
-    std::cout << "Current position: (" << current_position_.first << ", " << current_position_.second << ")\n";
-    std::cout << "Goal: (" << maze_.get_exit().first << ", " << maze_.get_exit().second << ")\n";
-    std::cout << "Use movement commands to navigate!\n\n";
+    out() << "🏁 RACE STARTED!\n";
+    out() << "Current position: (" << current_position_.first << ", " << current_position_.second << ")\n";
+    out() << "Goal: (" << maze_.get_exit().first << ", " << maze_.get_exit().second << ")\n";
+    out() << "Use movement commands to navigate!\n\n";
 
     print_current_state();
 }
@@ -112,11 +165,14 @@ void RaceMode::reset_race() {
     player_stats_ = PlayerStats();
     astar_stats_ = AStarStats();
 
-    if (std::ifstream(RACE_STATE_FILE)) {
+    if (options_.persistent && std::ifstream(RACE_STATE_FILE)) {
         std::remove(RACE_STATE_FILE.c_str());
     }
+    if (options_.persistent && std::ifstream(RACE_HINTS_FILE)) {
+        std::remove(RACE_HINTS_FILE.c_str());
+    }
 
-    std::cout << "🔄 Race reset. Use 'race_start' to begin again.\n";
+    out() << "🔄 Race reset. Use 'race_start' to begin again.\n";
 }
 
 // Validate if a move is possible
@@ -146,7 +202,7 @@ bool RaceMode::is_valid_move(int from_row, int from_col, int to_row, int to_col)
 // Attempt to move to a new position
 bool RaceMode::try_move(int new_row, int new_col, const std::string& direction) {
     if (!race_started_ || race_finished_) {
-        std::cout << "❌ Race not active! Use 'race_start' to begin.\n";
+        out() << "❌ Race not active! Use 'race_start' to begin.\n";
         return false;
     }
 
@@ -157,8 +213,8 @@ bool RaceMode::try_move(int new_row, int new_col, const std::string& direction)
 
         save_state(); // Save state after every move
 
-        std::cout << "✅ Moved " << direction << " to (" << new_row << ", " << new_col << ")\n";
-        std::cout << "Total moves: " << player_stats_.moves << "\n\n";
+        out() << "✅ Moved " << direction << " to (" << new_row << ", " << new_col << ")\n";
+        out() << "Total moves: " << player_stats_.moves << "\n\n";
 
         check_if_finished();
 
@@ -168,7 +224,7 @@ bool RaceMode::try_move(int new_row, int new_col, const std::string& direction)
 
         return true;
     } else {
-        std::cout << "🚫 Cannot move " << direction << " - wall blocking!\n\n";
+        out() << "🚫 Cannot move " << direction << " - wall blocking!\n\n";
         print_current_state();
         return false;
     }
@@ -202,24 +258,92 @@ void RaceMode::check_if_finished() {
 
         save_state();
 
-        std::cout << "\n╔════════════════════════════════════════════════╗\n";
-        std::cout << "║    🎉 CONGRATULATIONS! YOU WON! 🎉            ║\n";
-        std::cout << "╠════════════════════════════════════════════════╣\n";
-        std::cout << "║  You reached the exit!                         ║\n";
-        std::cout << "║  Total moves: " << std::setw(4) << player_stats_.moves << std::string(28, ' ') << "║\n";
-        std::cout << "║  Time: " << std::fixed << std::setprecision(2) << std::setw(7) << player_stats_.time_seconds << " seconds";
-        std::cout << std::string(23, ' ') << "║\n";
-        std::cout << "╚════════════════════════════════════════════════╝\n\n";
-
-        std::cout << "Computing optimal path with A* algorithm...\n\n";
+        out() << "\n╔════════════════════════════════════════════════╗\n";
+        out() << "║    🎉 CONGRATULATIONS! YOU WON! 🎉            ║\n";
+        out() << "╠════════════════════════════════════════════════╣\n";
+        out() << "║  You reached the exit!                         ║\n";
+        out() << "║  Total moves: " << std::setw(4) << player_stats_.moves << std::string(28, ' ') << "║\n";
+        out() << "║  Time: " << std::fixed << std::setprecision(2) << std::setw(7) << player_stats_.time_seconds << " seconds";
+        out() << std::string(23, ' ') << "║\n";
+        out() << "╚════════════════════════════════════════════════╝\n\n";
 
         run_astar();
         print_comparison();
 
-        // Clean up state file
-        if (std::ifstream(RACE_STATE_FILE)) {
+        // Clean up state files
+        if (options_.persistent && std::ifstream(RACE_STATE_FILE)) {
             std::remove(RACE_STATE_FILE.c_str());
         }
+        if (options_.persistent && std::ifstream(RACE_HINTS_FILE)) {
+            std::remove(RACE_HINTS_FILE.c_str());
+        }
+    }
+}
+
+// Optimal next move: the open neighbour one step closer to the exit
+RaceMode::Hint RaceMode::get_hint() {
+    Hint hint;
+    if (!race_started_ || race_finished_) return hint;
+
+    const auto [row, col] = current_position_;
+    const std::vector<std::pair<int, int>> cells = {
+        {row, col}, {row - 1, col}, {row + 1, col}, {row, col - 1}, {row, col + 1}
+    };
+    const std::string directions[] = {"UP ⬆️", "DOWN ⬇️", "LEFT ⬅️", "RIGHT ➡️"};
+
+    // A race without files and without a shared field computes its own once
+    if (!options_.hints && !options_.persistent) {
+        options_.hints = std::make_shared<const DistanceField>(DistanceField::compute(maze_, maze_.get_exit()));
+    }
+
+    std::vector<std::uint32_t> dist;
+    if (options_.hints) {
+        for (const auto& [r, c] : cells) {
+            const bool inside = r >= 0 && r < maze_.getRows() && c >= 0 && c < maze_.getCols();
+            dist.push_back(inside ? options_.hints->at(r, c) : DistanceField::UNREACHABLE);
+        }
+    } else {
+        // Older races or a replaced maze: rebuild the cache once
+        if (!hints_match_maze()) {
+            prepare_hints();
+        }
+        dist = DistanceField::read_cells(RACE_HINTS_FILE, cells);
+    }
+
+    if (dist[0] == DistanceField::UNREACHABLE) return hint;
+    hint.remaining = dist[0];
+    if (dist[0] == 0) {
+        hint.available = true;
+        hint.next = current_position_;
+        return hint;
+    }
+
+    for (size_t i = 1; i < cells.size(); i++) {
+        if (dist[i] + 1 == dist[0] &&
+            is_valid_move(row, col, cells[i].first, cells[i].second)) {
+            hint.available = true;
+            hint.direction = directions[i - 1];
+            hint.next = cells[i];
+            break;
+        }
+    }
+    return hint;
+}
+
+void RaceMode::print_hint() {
+    if (!race_started_ || race_finished_) {
+        out() << "❌ Race not active! Use 'race_start' to begin.\n";
+        return;
+    }
+
+    const Hint hint = get_hint();
+    if (!hint.available) {
+        out() << "🚫 The exit cannot be reached from here.\n";
+    } else if (hint.remaining == 0) {
+        out() << "🎯 You are at the exit!\n";
+    } else {
+        out() << "💡 Hint: move " << hint.direction << " to (" << hint.next.first << ", " << hint.next.second << ")\n";
+        out() << "Remaining distance: " << hint.remaining << " steps\n";
     }
 }
 
@@ -233,66 +357,122 @@ double RaceMode::get_elapsed_time() const {
     return elapsed.count();
 }
 
-// Run A* algorithm for comparison
-void RaceMode::run_astar() {
-    auto astar_start = std::chrono::steady_clock::now();
+// Number of timed solves; the median is reported
+constexpr std::uint32_t ASTAR_TIMING_RUNS = 5;
+
+// Solve once to warm up, then time repeated runs of find_path alone
+RaceMode::AStarStats RaceMode::solve_optimal(const Maze& maze) {
+    AStarStats stats;
+    Astar astar(maze);
+    stats.path = astar.find_path();
+    if (stats.path.empty()) return stats;
+
+    std::vector<double> runs;
+    for (std::uint32_t i = 0; i < ASTAR_TIMING_RUNS; i++) {
+        auto astar_start = std::chrono::steady_clock::now();
+        astar.find_path();
+        std::chrono::duration<double> astar_elapsed = std::chrono::steady_clock::now() - astar_start;
+        runs.push_back(astar_elapsed.count());
+    }
+    std::ranges::sort(runs);
+
+    stats.completed = true;
+    stats.moves = static_cast<int>(stats.path.size()) - 1;
+    stats.time_seconds = runs[runs.size() / 2];
+    return stats;
+}
+
+// Wait for a pending background solve and persist it with the race
+void RaceMode::collect_astar() {
+    if (!astar_task_.valid()) return;
+
+    astar_stats_ = astar_task_.get();
+    const bool shared = options_.optimal.valid();
+    astar_task_ = {};
+    if (!shared) {
+        store_cached_optimal();
+    }
+    if (race_started_ && !race_finished_) {
+        save_state();
+    }
+}
+
+// Solutions of earlier races on the same maze are reused. A 'find' entry holds a single
+// cold solve, not the race's median, so it is solved and timed again
+bool RaceMode::load_cached_optimal() {
+    if (!options_.persistent) return false;
 
-    Astar astar(maze_);
-    astar_stats_.path = astar.find_path();
+    SolutionCache cache;
+    const auto cached = cache.find(SolutionCache::key_of(maze_));
+    if (!cached || cached->path.empty() || cached->runs < ASTAR_TIMING_RUNS) return false;
 
-    auto astar_end = std::chrono::steady_clock::now();
-    std::chrono::duration<double> astar_elapsed = astar_end - astar_start;
+    astar_stats_.path = cached->path;
+    astar_stats_.moves = static_cast<int>(cached->path.size()) - 1;
+    astar_stats_.time_seconds = cached->seconds;
+    astar_stats_.completed = true;
+    return true;
+}
+
+void RaceMode::store_cached_optimal() const {
+    if (!options_.persistent || !astar_stats_.completed) return;
 
-    if (!astar_stats_.path.empty()) {
-        astar_stats_.completed = true;
-        astar_stats_.moves = static_cast<int>(astar_stats_.path.size()) - 1;
-        astar_stats_.time_seconds = astar_elapsed.count();
+    SolutionCache cache;
+    cache.store(SolutionCache::key_of(maze_), astar_stats_.path, astar_stats_.time_seconds, ASTAR_TIMING_RUNS);
+}
+
+// Use the background result, solving now only if none is available
+void RaceMode::run_astar() {
+    collect_astar();
+    if (!astar_stats_.completed && !load_cached_optimal()) {
+        out() << "Computing optimal path with A* algorithm...\n\n";
+        astar_stats_ = solve_optimal(maze_);
+        store_cached_optimal();
     }
 }
 
 // Print comparison results
 void RaceMode::print_comparison() const {
     if (!player_stats_.completed || !astar_stats_.completed) {
-        std::cout << "Cannot compare - race not completed!\n";
+        out() << "Cannot compare - race not completed!\n";
         return;
     }
 
-    std::cout << "╔════════════════════════════════════════════════╗\n";
-    std::cout << "║         🏁 RACE RESULTS COMPARISON 🏁          ║\n";
-    std::cout << "╠════════════════════════════════════════════════╣\n";
+    out() << "╔════════════════════════════════════════════════╗\n";
+    out() << "║         🏁 RACE RESULTS COMPARISON 🏁          ║\n";
+    out() << "╠════════════════════════════════════════════════╣\n";
 
-    std::cout << "║  MOVES:                                        ║\n";
-    std::cout << "║    👤 Player:  " << std::setw(4) << player_stats_.moves << " moves" << std::string(24, ' ') << "║\n";
-    std::cout << "║    🤖 A*:      " << std::setw(4) << astar_stats_.moves << " moves (optimal)" << std::string(13, ' ') << "║\n";
+    out() << "║  MOVES:                                        ║\n";
+    out() << "║    👤 Player:  " << std::setw(4) << player_stats_.moves << " moves" << std::string(24, ' ') << "║\n";
+    out() << "║    🤖 A*:      " << std::setw(4) << astar_stats_.moves << " moves (optimal)" << std::string(13, ' ') << "║\n";
 
     double efficiency = (static_cast<double>(astar_stats_.moves) / player_stats_.moves) * 100.0;
     std::stringstream ss;
     ss << std::fixed << std::setprecision(1) << efficiency;
     std::string efficiency_str = ss.str();
 
-    std::cout << "║    📊 Efficiency: " << efficiency_str << "%";
+    out() << "║    📊 Efficiency: " << efficiency_str << "%";
     int padding = 27 - static_cast<int>(efficiency_str.length());
-    std::cout << std::string(padding, ' ') << "║\n";
+    out() << std::string(padding, ' ') << "║\n";
 
     if (player_stats_.moves == astar_stats_.moves) {
-        std::cout << "║    ⭐⭐⭐ PERFECT! Optimal path! ⭐⭐⭐          ║\n";
+        out() << "║    ⭐⭐⭐ PERFECT! Optimal path! ⭐⭐⭐          ║\n";
     } else if (efficiency >= 90.0) {
-        std::cout << "║    🌟 EXCELLENT! Very close to optimal!       ║\n";
+        out() << "║    🌟 EXCELLENT! Very close to optimal!       ║\n";
     } else if (efficiency >= 75.0) {
-        std::cout << "║    👍 GOOD! Solid performance!                 ║\n";
+        out() << "║    👍 GOOD! Solid performance!                 ║\n";
     } else if (efficiency >= 50.0) {
-        std::cout << "║    📈 Not bad! Room for improvement!           ║\n";
+        out() << "║    📈 Not bad! Room for improvement!           ║\n";
     } else {
-        std::cout << "║    💪 Keep practicing! You'll get better!      ║\n";
+        out() << "║    💪 Keep practicing! You'll get better!      ║\n";
     }
 
-    std::cout << "╠════════════════════════════════════════════════╣\n";
+    out() << "╠════════════════════════════════════════════════╣\n";
 
-    std::cout << "║  TIME:                                         ║\n";
-    std::cout << "║    👤 Player:  " << std::fixed << std::setprecision(3)
+    out() << "║  TIME:                                         ║\n";
+    out() << "║    👤 Player:  " << std::fixed << std::setprecision(3)
               << std::setw(8) << player_stats_.time_seconds << " sec"
               << std::string(18, ' ') << "║\n";
-    std::cout << "║    🤖 A*:      " << std::fixed << std::setprecision(6)
+    out() << "║    🤖 A*:      " << std::fixed << std::setprecision(6)
               << std::setw(11) << astar_stats_.time_seconds << " sec"
               << std::string(15, ' ') << "║\n";
 
@@ -301,23 +481,23 @@ void RaceMode::print_comparison() const {
     ratio_ss << std::fixed << std::setprecision(0) << time_ratio;
     std::string ratio_str = ratio_ss.str();
 
-    std::cout << "║    ⚡ A* was " << ratio_str << "x faster";
+    out() << "║    ⚡ A* was " << ratio_str << "x faster";
     int time_padding = 31 - static_cast<int>(ratio_str.length());
-    std::cout << std::string(time_padding, ' ') << "║\n";
+    out() << std::string(time_padding, ' ') << "║\n";
 
-    std::cout << "╠════════════════════════════════════════════════╣\n";
+    out() << "╠════════════════════════════════════════════════╣\n";
 
     int extra_moves = player_stats_.moves - astar_stats_.moves;
     if (extra_moves > 0) {
         std::string moves_str = "  Extra moves: " + std::to_string(extra_moves);
-        std::cout << "║" << moves_str;
+        out() << "║" << moves_str;
         int final_padding = 48 - static_cast<int>(moves_str.length());
-        std::cout << std::string(final_padding, ' ') << "║\n";
+        out() << std::string(final_padding, ' ') << "║\n";
     } else {
-        std::cout << "║  Perfect navigation! 🎯                        ║\n";
+        out() << "║  Perfect navigation! 🎯                        ║\n";
     }
 
-    std::cout << "╚════════════════════════════════════════════════╝\n\n";
+    out() << "╚════════════════════════════════════════════════╝\n\n";
 }
 
 // Save results to file
@@ -325,7 +505,7 @@ void RaceMode::save_results_to_file(const std::string& filename) const {
     std::ofstream file(filename);
 
     if (!file.is_open()) {
-        std::cout << "Error: Could not save results to file!\n";
+        out() << "Error: Could not save results to file!\n";
         return;
     }
 
@@ -363,81 +543,164 @@ void RaceMode::save_results_to_file(const std::string& filename) const {
     }
 
     file.close();
-    std::cout << "✅ Results saved to: " << filename << "\n";
+    out() << "✅ Results saved to: " << filename << "\n";
 }
 
 // Print current maze state with player position
 void RaceMode::print_current_state() const {
+    if (!options_.out) return;
+
+    out() << "\n" << render_frame();
+
+    // Print legend and stats
+    out() << "Legend: @ = You, E = Entrance, X = Exit\n";
+    out() << "Position: (" << current_position_.first << ", " << current_position_.second << ")";
+    out() << " | Moves: " << player_stats_.moves;
+
+    if (race_started_ && !race_finished_) {
+        out() << " | Time: " << std::fixed << std::setprecision(1) << get_elapsed_time() << "s";
+    }
+
+    out() << "\n\n";
+}
+
+// Draws only the viewport around the player into one buffer, so the cost of a frame
+// depends on the window size and not on the maze size
+std::string RaceMode::render_frame() const {
     const auto entrance = maze_.get_entrance();
     const auto exit = maze_.get_exit();
+    const auto& vWalls = maze_.get_v_walls();
+    const auto& hWalls = maze_.get_h_walls();
     const int rows = maze_.getRows();
     const int cols = maze_.getCols();
 
-    std::cout << "\n";
+    const int view_rows = options_.viewport_rows > 0 ? std::min(options_.viewport_rows, rows) : rows;
+    const int view_cols = options_.viewport_cols > 0 ? std::min(options_.viewport_cols, cols) : cols;
+    const int row0 = std::clamp(current_position_.first - view_rows / 2, 0, rows - view_rows);
+    const int col0 = std::clamp(current_position_.second - view_cols / 2, 0, cols - view_cols);
+    const int row1 = row0 + view_rows;
+    const int col1 = col0 + view_cols;
+
+    std::string frame;
+    frame.reserve(static_cast<size_t>(view_rows * 2 + 8) * (view_cols * 4 + 2));
+    if (view_rows < rows || view_cols < cols) {
+        frame += "Viewport: rows " + std::to_string(row0) + "-" + std::to_string(row1 - 1) +
+                 ", cols " + std::to_string(col0) + "-" + std::to_string(col1 - 1) +
+                 " of " + std::to_string(rows) + "x" + std::to_string(cols) + "\n";
+    }
 
-    // Print top border
-    for (int j = 0; j < cols; j++) {
-        std::cout << "+";
-        if (entrance.first == 0 && entrance.second == j) {
-            std::cout << " E ";
+    // Top edge: the maze border, or the walls above the window
+    for (int j = col0; j < col1; j++) {
+        frame += "+";
+        if (row0 > 0) {
+            frame += hWalls(row0 - 1, j) ? "---" : "   ";
         } else {
-            std::cout << "---";
+            frame += entrance.first == 0 && entrance.second == j ? " E " : "---";
         }
     }
-    std::cout << "+\n";
+    frame += "+\n";
 
     // Print maze with current position marked
-    for (int i = 0; i < rows; i++) {
-        std::cout << "|";
-        for (int j = 0; j < cols; j++) {
+    for (int i = row0; i < row1; i++) {
+        frame += col0 > 0 && !vWalls(i, col0 - 1) ? " " : "|";
+        for (int j = col0; j < col1; j++) {
             if (current_position_.first == i && current_position_.second == j) {
-                std::cout << " @ ";  // Current position
+                frame += " @ ";  // Current position
             } else if (entrance.first == i && entrance.second == j) {
-                std::cout << " E ";
+                frame += " E ";
             } else if (exit.first == i && exit.second == j) {
-                std::cout << " X ";
+                frame += " X ";
             } else {
-                std::cout << "   ";
+                frame += "   ";
             }
 
             if (j < cols - 1) {
-                std::cout << (maze_.get_v_walls()(i, j) ? "|" : " ");
+                frame += vWalls(i, j) ? "|" : " ";
             } else {
-                std::cout << "|";
+                frame += "|";
             }
         }
-        std::cout << "\n";
+        frame += "\n";
 
         if (i < rows - 1) {
-            std::cout << "+";
-            for (int j = 0; j < cols; j++) {
-                std::cout << (maze_.get_h_walls()(i, j) ? "---+" : "   +");
+            frame += "+";
+            for (int j = col0; j < col1; j++) {
+                frame += hWalls(i, j) ? "---+" : "   +";
             }
-            std::cout << "\n";
+            frame += "\n";
         }
     }
 
     // Print bottom border
-    std::cout << "+";
-    for (int j = 0; j < cols; j++) {
-        if (exit.first == rows - 1 && exit.second == j) {
-            std::cout << " X +";
-        } else {
-            std::cout << "---+";
+    if (row1 == rows) {
+        frame += "+";
+        for (int j = col0; j < col1; j++) {
+            frame += exit.first == rows - 1 && exit.second == j ? " X +" : "---+";
         }
+        frame += "\n";
     }
-    std::cout << "\n\n";
-
-    // Print legend and stats
-    std::cout << "Legend: @ = You, E = Entrance, X = Exit\n";
-    std::cout << "Position: (" << current_position_.first << ", " << current_position_.second << ")";
-    std::cout << " | Moves: " << player_stats_.moves;
+    frame += "\n";
 
-    if (race_started_ && !race_finished_) {
-        std::cout << " | Time: " << std::fixed << std::setprecision(1) << get_elapsed_time() << "s";
+    if (options_.minimap) {
+        append_minimap(frame, row0, col0, view_rows, view_cols);
     }
+    return frame;
+}
 
-    std::cout << "\n\n";
+// Constant-size overview: each character covers a block of cells and is shaded by
+// sampling at most 3x3 cells of the block, so its cost does not grow with the maze
+void RaceMode::append_minimap(std::string& frame, const int row0, const int col0,
+                              const int rows, const int cols) const {
+    constexpr int MINIMAP_COLS = 40;
+    constexpr int SAMPLES = 3;
+    const char SHADES[] = " .:=#";
+
+    const int maze_rows = maze_.getRows();
+    const int maze_cols = maze_.getCols();
+    const int map_cols = std::min(maze_cols, MINIMAP_COLS);
+    // Terminal characters are about twice as tall as wide
+    const int map_rows = std::clamp(maze_rows * map_cols / maze_cols / 2, 1, maze_rows);
+
+    const auto block = [](const int index, const int blocks, const int size) {
+        return static_cast<int>(static_cast<long long>(index) * size / blocks);
+    };
+    const auto inside = [](const std::pair<int, int>& cell, const int r0, const int r1, const int c0, const int c1) {
+        return cell.first >= r0 && cell.first < r1 && cell.second >= c0 && cell.second < c1;
+    };
+
+    frame += "Minimap (* = viewport):\n+" + std::string(map_cols, '-') + "+\n";
+    for (int br = 0; br < map_rows; br++) {
+        const int r0 = block(br, map_rows, maze_rows);
+        const int r1 = std::max(block(br + 1, map_rows, maze_rows), r0 + 1);
+        frame += "|";
+        for (int bc = 0; bc < map_cols; bc++) {
+            const int c0 = block(bc, map_cols, maze_cols);
+            const int c1 = std::max(block(bc + 1, map_cols, maze_cols), c0 + 1);
+
+            if (inside(current_position_, r0, r1, c0, c1)) {
+                frame += '@';
+            } else if (inside(maze_.get_exit(), r0, r1, c0, c1)) {
+                frame += 'X';
+            } else if (inside(maze_.get_entrance(), r0, r1, c0, c1)) {
+                frame += 'E';
+            } else if (r0 < row0 + rows && r1 > row0 && c0 < col0 + cols && c1 > col0) {
+                frame += '*';
+            } else {
+                int walls = 0, samples = 0;
+                for (int sr = 0; sr < SAMPLES; sr++) {
+                    for (int sc = 0; sc < SAMPLES; sc++) {
+                        const int r = r0 + (r1 - r0) * sr / SAMPLES;
+                        const int c = c0 + (c1 - c0) * sc / SAMPLES;
+                        walls += maze_.get_v_walls()(r, c) + maze_.get_h_walls()(r, c);
+                        samples += 2;
+                    }
+                }
+                frame += SHADES[walls * 4 / samples];
+            }
+        }
+        frame += "|\n";
+    }
+    frame += "+" + std::string(map_cols, '-') + "+\n\n";
 }
 
 } // namespace course
\ No newline at end of file
@@ -0,0 +1,280 @@
+//
+// Interactive race: raw keyboard input and incremental ANSI redraw
+//
+
+#include <raceplay.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <conio.h>
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace course {
+    namespace {
+        // Identical characters shorter than this between two changes are resent
+        // rather than paying for another cursor move
+        constexpr size_t MERGE_GAP = 6;
+
+        void move_cursor(std::string& out, const size_t row, const size_t col) {
+            out += "\x1b[" + std::to_string(row + 1) + ";" + std::to_string(col + 1) + "H";
+        }
+
+        std::string describe_step(const std::pair<int, int>& from, const std::pair<int, int>& to) {
+            if (to.first < from.first) return "UP";
+            if (to.first > from.first) return "DOWN";
+            if (to.second < from.second) return "LEFT";
+            return "RIGHT";
+        }
+    }
+
+    void FrameBuffer::assign(const std::string& text) {
+        next_.clear();
+        size_t begin = 0;
+        while (begin < text.size()) {
+            size_t end = text.find('\n', begin);
+            if (end == std::string::npos) end = text.size();
+            next_.emplace_back(text, begin, end - begin);
+            begin = end + 1;
+        }
+    }
+
+    size_t FrameBuffer::present(std::ostream& out) {
+        std::string bytes;
+        if (full_) {
+            bytes = "\x1b[H\x1b[2J";
+            for (size_t row = 0; row < next_.size(); row++) {
+                move_cursor(bytes, row, 0);
+                bytes += next_[row];
+            }
+            full_ = false;
+        } else {
+            const size_t lines = std::max(shown_.size(), next_.size());
+            for (size_t row = 0; row < lines; row++) {
+                const std::string empty;
+                const std::string& before = row < shown_.size() ? shown_[row] : empty;
+                const std::string& after = row < next_.size() ? next_[row] : empty;
+                const size_t width = std::max(before.size(), after.size());
+                const auto at = [width](const std::string& line, const size_t col) {
+                    return col < line.size() ? line[col] : ' ';
+                };
+
+                size_t col = 0;
+                while (col < width) {
+                    if (at(before, col) == at(after, col)) {
+                        col++;
+                        continue;
+                    }
+                    // Extend the run over short stretches of unchanged characters
+                    size_t end = col + 1, same = 0;
+                    for (size_t k = end; k < width && same < MERGE_GAP; k++) {
+                        if (at(before, k) == at(after, k)) {
+                            same++;
+                        } else {
+                            same = 0;
+                            end = k + 1;
+                        }
+                    }
+                    move_cursor(bytes, row, col);
+                    if (end >= after.size()) {
+                        // The rest of the line is blank now: erase it instead of padding
+                        bytes.append(after, std::min(col, after.size()));
+                        bytes += "\x1b[K";
+                        break;
+                    }
+                    bytes.append(after, col, end - col);
+                    col = end;
+                }
+            }
+        }
+
+        shown_ = next_;
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        out.flush();
+        return bytes.size();
+    }
+
+#ifdef _WIN32
+    struct RawTerminal::State {
+        HANDLE output;
+        DWORD mode;
+    };
+
+    RawTerminal::RawTerminal() : state_(std::make_unique<State>()) {
+        state_->output = GetStdHandle(STD_OUTPUT_HANDLE);
+        if (!GetConsoleMode(state_->output, &state_->mode)) {
+            throw std::runtime_error("race_play needs an interactive terminal");
+        }
+        SetConsoleMode(state_->output, state_->mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        std::fputs("\x1b[?1049h\x1b[?25l", stdout);
+        std::fflush(stdout);
+    }
+
+    RawTerminal::~RawTerminal() {
+        std::fputs("\x1b[?25h\x1b[?1049l", stdout);
+        std::fflush(stdout);
+        SetConsoleMode(state_->output, state_->mode);
+    }
+
+    RawTerminal::Key RawTerminal::read_key() {
+        int c = _getch();
+        if (c == 0 || c == 224) {
+            switch (_getch()) {
+                case 72: return Key::Up;
+                case 80: return Key::Down;
+                case 75: return Key::Left;
+                case 77: return Key::Right;
+                default: return Key::None;
+            }
+        }
+        switch (c) {
+            case 'w': case 'k': return Key::Up;
+            case 's': case 'j': return Key::Down;
+            case 'a': case 'h': return Key::Left;
+            case 'd': case 'l': return Key::Right;
+            case '?': return Key::Hint;
+            case 'r': return Key::Redraw;
+            case 'q': case 3: case 27: return Key::Quit;
+            default: return Key::None;
+        }
+    }
+
+    std::pair<int, int> RawTerminal::size() {
+        CONSOLE_SCREEN_BUFFER_INFO info;
+        if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) return {24, 80};
+        return {info.srWindow.Bottom - info.srWindow.Top + 1, info.srWindow.Right - info.srWindow.Left + 1};
+    }
+#else
+    struct RawTerminal::State {
+        termios saved;
+    };
+
+    RawTerminal::RawTerminal() : state_(std::make_unique<State>()) {
+        if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &state_->saved) != 0) {
+            throw std::runtime_error("race_play needs an interactive terminal");
+        }
+        termios raw = state_->saved;
+        raw.c_lflag &= ~(ICANON | ECHO | ISIG);
+        raw.c_iflag &= ~(IXON | ICRNL);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+
+        // Alternate screen, hidden cursor
+        constexpr char enter[] = "\x1b[?1049h\x1b[?25l";
+        [[maybe_unused]] const auto written = write(STDOUT_FILENO, enter, sizeof(enter) - 1);
+    }
+
+    RawTerminal::~RawTerminal() {
+        constexpr char leave[] = "\x1b[?25h\x1b[?1049l";
+        [[maybe_unused]] const auto written = write(STDOUT_FILENO, leave, sizeof(leave) - 1);
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &state_->saved);
+    }
+
+    RawTerminal::Key RawTerminal::read_key() {
+        char c;
+        if (read(STDIN_FILENO, &c, 1) != 1) return Key::Quit;
+
+        if (c == '\x1b') {
+            // Arrow keys arrive as ESC [ A..D; a lone ESC quits
+            char sequence[2];
+            termios current;
+            tcgetattr(STDIN_FILENO, &current);
+            termios timed = current;
+            timed.c_cc[VMIN] = 0;
+            timed.c_cc[VTIME] = 1;
+            tcsetattr(STDIN_FILENO, TCSANOW, &timed);
+            const auto got = read(STDIN_FILENO, sequence, 2);
+            tcsetattr(STDIN_FILENO, TCSANOW, &current);
+
+            if (got <= 0) return Key::Quit;
+            if (got < 2 || (sequence[0] != '[' && sequence[0] != 'O')) return Key::None;
+            switch (sequence[1]) {
+                case 'A': return Key::Up;
+                case 'B': return Key::Down;
+                case 'C': return Key::Right;
+                case 'D': return Key::Left;
+                default: return Key::None;
+            }
+        }
+
+        switch (c) {
+            case 'w': case 'k': return Key::Up;
+            case 's': case 'j': return Key::Down;
+            case 'a': case 'h': return Key::Left;
+            case 'd': case 'l': return Key::Right;
+            case '?': return Key::Hint;
+            case 'r': case '\x0c': return Key::Redraw;
+            case 'q': case '\x03': case '\x04': return Key::Quit;
+            default: return Key::None;
+        }
+    }
+
+    std::pair<int, int> RawTerminal::size() {
+        winsize ws{};
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 || ws.ws_row == 0 || ws.ws_col == 0) return {24, 80};
+        return {ws.ws_row, ws.ws_col};
+    }
+#endif
+
+    // Each key rebuilds the viewport text, which is bounded by the window size, and
+    // the frame buffer sends only the cells that differ from what is on screen
+    bool play_race(RaceMode& race, std::ostream& out) {
+        RawTerminal terminal;
+        FrameBuffer screen;
+        std::string message = "Arrows/WASD/hjkl move, ? hint, r repaint, q quit";
+
+        while (!race.is_race_finished()) {
+            const auto [row, col] = race.get_position();
+            std::ostringstream status;
+            status << "Position: (" << row << ", " << col << ") | Moves: " << race.get_player_stats().moves
+                   << " | Time: " << std::fixed << std::setprecision(1) << race.get_elapsed_time() << "s\n"
+                   << message << "\n";
+            screen.assign(race.render_frame() + status.str());
+            screen.present(out);
+
+            const auto key = terminal.read_key();
+            message.clear();
+            switch (key) {
+                case RawTerminal::Key::Up:
+                    if (!race.move_up()) message = "Wall blocks UP";
+                    break;
+                case RawTerminal::Key::Down:
+                    if (!race.move_down()) message = "Wall blocks DOWN";
+                    break;
+                case RawTerminal::Key::Left:
+                    if (!race.move_left()) message = "Wall blocks LEFT";
+                    break;
+                case RawTerminal::Key::Right:
+                    if (!race.move_right()) message = "Wall blocks RIGHT";
+                    break;
+                case RawTerminal::Key::Hint: {
+                    const auto hint = race.get_hint();
+                    message = hint.available
+                                  ? "Hint: go " + describe_step(race.get_position(), hint.next) + ", " +
+                                    std::to_string(hint.remaining) + " steps to the exit"
+                                  : "No hint available";
+                    break;
+                }
+                case RawTerminal::Key::Redraw:
+                    screen.invalidate();
+                    break;
+                case RawTerminal::Key::Quit:
+                    return false;
+                case RawTerminal::Key::None:
+                    break;
+            }
+        }
+        return true;
+    }
+}
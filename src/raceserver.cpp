@@ -0,0 +1,102 @@
+//
+// In-memory race sessions over one shared, read-only maze
+//
+
+#include <raceserver.h>
+
+#include <distance.h>
+#include <algorithm>
+
+namespace course {
+    RaceServer::RaceServer(const Maze& maze, const unsigned shards)
+        : maze_(maze), shards_(std::max(shards, 1u)) {
+        optimal_ = std::async(std::launch::async, RaceMode::solve_optimal, std::cref(maze_)).share();
+        hints_ = std::make_shared<const DistanceField>(DistanceField::compute(maze_, maze_.get_exit()));
+    }
+
+    RaceServer::SessionId RaceServer::create_session() {
+        RaceMode::Options options;
+        options.persistent = false;
+        options.out = nullptr;
+        options.optimal = optimal_;
+        options.hints = hints_;
+
+        // Build and start outside the shard lock, only the insert is exclusive
+        auto session = std::make_shared<Session>(maze_, options);
+        session->race.start_race();
+
+        const SessionId id = nextId_.fetch_add(1, std::memory_order_relaxed);
+        Shard& shard = shard_of(id);
+        std::unique_lock lock(shard.mutex);
+        shard.sessions.emplace(id, std::move(session));
+        return id;
+    }
+
+    bool RaceServer::close_session(const SessionId id) {
+        std::shared_ptr<Session> session;
+        {
+            Shard& shard = shard_of(id);
+            std::unique_lock lock(shard.mutex);
+            const auto it = shard.sessions.find(id);
+            if (it == shard.sessions.end()) return false;
+            session = std::move(it->second);
+            shard.sessions.erase(it);
+        }
+        // The race is destroyed here, or by the last move still holding it
+        return true;
+    }
+
+    std::shared_ptr<RaceServer::Session> RaceServer::find(const SessionId id) {
+        Shard& shard = shard_of(id);
+        std::shared_lock lock(shard.mutex);
+        const auto it = shard.sessions.find(id);
+        return it == shard.sessions.end() ? nullptr : it->second;
+    }
+
+    RaceServer::MoveResult RaceServer::move(const SessionId id, const Direction direction) {
+        const auto session = find(id);
+        if (!session) return MoveResult::NoSession;
+
+        std::lock_guard lock(session->mutex);
+        RaceMode& race = session->race;
+        if (!race.is_race_started() || race.is_race_finished()) return MoveResult::Inactive;
+
+        bool moved = false;
+        switch (direction) {
+            case Direction::Up: moved = race.move_up(); break;
+            case Direction::Down: moved = race.move_down(); break;
+            case Direction::Left: moved = race.move_left(); break;
+            case Direction::Right: moved = race.move_right(); break;
+        }
+
+        if (!moved) return MoveResult::Blocked;
+        return race.is_race_finished() ? MoveResult::Finished : MoveResult::Moved;
+    }
+
+    RaceMode::Hint RaceServer::hint(const SessionId id) {
+        const auto session = find(id);
+        if (!session) return {};
+
+        std::lock_guard lock(session->mutex);
+        return session->race.get_hint();
+    }
+
+    bool RaceServer::snapshot(const SessionId id, std::pair<int, int>& position, RaceMode::PlayerStats& stats) {
+        const auto session = find(id);
+        if (!session) return false;
+
+        std::lock_guard lock(session->mutex);
+        position = session->race.get_position();
+        stats = session->race.get_player_stats();
+        return true;
+    }
+
+    size_t RaceServer::session_count() const {
+        size_t count = 0;
+        for (const Shard& shard : shards_) {
+            std::shared_lock lock(shard.mutex);
+            count += shard.sessions.size();
+        }
+        return count;
+    }
+}
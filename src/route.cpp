@@ -0,0 +1,260 @@
+//
+// Checkpoint routes: entrance, every waypoint in the best order found, then the exit
+//
+
+#include <route.h>
+
+#include <algorithm>
+#include <astar.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <searchcore.h>
+#include <sstream>
+#include <stdexcept>
+#include <threadpool.h>
+
+namespace course {
+    namespace {
+        // Per-thread BFS state, reused across sources. Cells count as unseen unless their
+        // stamp is the current search's, so nothing is cleared between searches
+        struct SearchBuffers {
+            std::vector<std::uint32_t> stamp;
+            std::vector<std::uint32_t> dist;
+            std::vector<std::uint32_t> queue;
+            std::uint32_t search = 0;
+        };
+
+        constexpr std::uint64_t NO_ROUTE = ~std::uint64_t{0};
+
+        std::uint64_t route_length(const std::vector<std::uint32_t>& matrix, const size_t n,
+                                   const std::vector<size_t>& stops) {
+            std::uint64_t total = 0;
+            for (size_t i = 0; i + 1 < stops.size(); i++) {
+                const std::uint32_t d = matrix[stops[i] * n + stops[i + 1]];
+                if (d == RouteResult::UNREACHABLE) return NO_ROUTE;
+                total += d;
+            }
+            return total;
+        }
+
+        // Held-Karp over the waypoints 1..k with stop 0 fixed first and stop k+1 last
+        std::vector<size_t> exact_order(const std::vector<std::uint32_t>& matrix, const size_t n) {
+            const size_t k = n - 2;
+            const size_t subsets = size_t{1} << k;
+            std::vector<std::uint64_t> best(subsets * k, NO_ROUTE);
+            std::vector<std::uint8_t> previous(subsets * k, 0);
+            const auto dist = [&](const size_t a, const size_t b) -> std::uint64_t {
+                const std::uint32_t d = matrix[a * n + b];
+                return d == RouteResult::UNREACHABLE ? NO_ROUTE : d;
+            };
+
+            for (size_t last = 0; last < k; last++)
+                best[(size_t{1} << last) * k + last] = dist(0, last + 1);
+            for (size_t set = 1; set < subsets; set++) {
+                for (size_t last = 0; last < k; last++) {
+                    const std::uint64_t here = best[set * k + last];
+                    if (!(set >> last & 1) || here == NO_ROUTE) continue;
+                    for (size_t next = 0; next < k; next++) {
+                        const std::uint64_t step = dist(last + 1, next + 1);
+                        if (set >> next & 1 || step == NO_ROUTE) continue;
+                        const size_t into = (set | size_t{1} << next) * k + next;
+                        if (here + step < best[into]) {
+                            best[into] = here + step;
+                            previous[into] = static_cast<std::uint8_t>(last);
+                        }
+                    }
+                }
+            }
+
+            const size_t all = subsets - 1;
+            std::uint64_t bestTotal = NO_ROUTE;
+            size_t bestLast = 0;
+            for (size_t last = 0; last < k; last++) {
+                const std::uint64_t tail = dist(last + 1, n - 1);
+                if (best[all * k + last] == NO_ROUTE || tail == NO_ROUTE) continue;
+                if (best[all * k + last] + tail < bestTotal) {
+                    bestTotal = best[all * k + last] + tail;
+                    bestLast = last;
+                }
+            }
+            if (bestTotal == NO_ROUTE)
+                throw std::runtime_error("Some waypoints cannot be reached");
+
+            std::vector<size_t> stops = {n - 1};
+            for (size_t set = all, last = bestLast; set;) {
+                stops.push_back(last + 1);
+                const size_t before = previous[set * k + last];
+                set &= ~(size_t{1} << last);
+                last = before;
+            }
+            stops.push_back(0);
+            std::ranges::reverse(stops);
+            return stops;
+        }
+
+        // Nearest unvisited waypoint first, then 2-opt reversals of inner segments until
+        // none shortens the route
+        std::vector<size_t> heuristic_order(const std::vector<std::uint32_t>& matrix, const size_t n) {
+            std::vector<size_t> stops = {0};
+            std::vector<bool> used(n, false);
+            used[0] = used[n - 1] = true;
+            for (size_t step = 1; step + 1 < n; step++) {
+                size_t pick = n;
+                for (size_t j = 1; j + 1 < n; j++) {
+                    if (!used[j] && (pick == n || matrix[stops.back() * n + j] < matrix[stops.back() * n + pick]))
+                        pick = j;
+                }
+                used[pick] = true;
+                stops.push_back(pick);
+            }
+            stops.push_back(n - 1);
+
+            std::uint64_t length = route_length(matrix, n, stops);
+            if (length == NO_ROUTE)
+                throw std::runtime_error("Some waypoints cannot be reached");
+            for (bool improved = true; improved;) {
+                improved = false;
+                for (size_t i = 1; i + 1 < stops.size(); i++) {
+                    for (size_t j = i + 1; j + 1 < stops.size(); j++) {
+                        std::reverse(stops.begin() + static_cast<std::ptrdiff_t>(i),
+                                     stops.begin() + static_cast<std::ptrdiff_t>(j) + 1);
+                        if (const std::uint64_t candidate = route_length(matrix, n, stops); candidate < length) {
+                            length = candidate;
+                            improved = true;
+                        } else {
+                            std::reverse(stops.begin() + static_cast<std::ptrdiff_t>(i),
+                                         stops.begin() + static_cast<std::ptrdiff_t>(j) + 1);
+                        }
+                    }
+                }
+            }
+            return stops;
+        }
+    }
+
+    std::vector<std::pair<int, int>> read_waypoints(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        std::vector<std::pair<int, int>> waypoints;
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream words(line);
+            int row, col;
+            if (line.empty() || line[0] == '#' || !(words >> row)) continue;
+            if (!(words >> col))
+                throw std::invalid_argument("Waypoint needs a row and a column: " + line);
+            waypoints.emplace_back(row, col);
+        }
+        return waypoints;
+    }
+
+    std::vector<std::uint32_t> distance_matrix(const Maze& maze, const std::vector<std::pair<int, int>>& points,
+                                               const unsigned threads) {
+        const int rows = maze.getRows();
+        const int cols = maze.getCols();
+        const size_t cells = static_cast<size_t>(rows) * cols;
+        const size_t n = points.size();
+        for (const auto& [r, c] : points)
+            if (r < 0 || r >= rows || c < 0 || c >= cols)
+                throw std::out_of_range("Route stop outside the maze");
+
+        ThreadPool pool(threads);
+        const OpenGrid grid(maze, &pool);
+        const auto& open = grid.open;
+
+        // Stops per cell, so a search knows when it has found the last one
+        std::vector<std::uint32_t> targets(cells, 0);
+        std::vector<std::uint32_t> index(n);
+        for (size_t i = 0; i < n; i++) {
+            index[i] = static_cast<std::uint32_t>(points[i].first * cols + points[i].second);
+            targets[index[i]]++;
+        }
+
+        std::vector<std::uint32_t> matrix(n * n, RouteResult::UNREACHABLE);
+        std::atomic<size_t> nextRow{0};
+        pool.run_on_all([&](unsigned) {
+            SearchBuffers buffers;
+            buffers.stamp.assign(cells, 0);
+            buffers.dist.resize(cells);
+            buffers.queue.resize(cells);
+            auto& stamp = buffers.stamp;
+            auto& dist = buffers.dist;
+            auto& queue = buffers.queue;
+
+            for (size_t source = nextRow++; source < n; source = nextRow++) {
+                const std::uint32_t search = ++buffers.search;
+                size_t head = 0, tail = 0;
+                size_t remaining = n - targets[index[source]];
+                stamp[index[source]] = search;
+                dist[index[source]] = 0;
+                queue[tail++] = index[source];
+
+                while (head < tail && remaining > 0) {
+                    const std::uint32_t cell = queue[head++];
+                    const std::uint8_t sides = open[cell];
+                    const auto visit = [&](const std::uint32_t neighbor) {
+                        if (stamp[neighbor] == search) return;
+                        stamp[neighbor] = search;
+                        dist[neighbor] = dist[cell] + 1;
+                        remaining -= targets[neighbor];
+                        queue[tail++] = neighbor;
+                    };
+                    if (sides & OpenGrid::Up) visit(cell - cols);
+                    if (sides & OpenGrid::Down) visit(cell + cols);
+                    if (sides & OpenGrid::Left) visit(cell - 1);
+                    if (sides & OpenGrid::Right) visit(cell + 1);
+                }
+
+                for (size_t j = 0; j < n; j++)
+                    if (stamp[index[j]] == search) matrix[source * n + j] = dist[index[j]];
+            }
+        });
+        return matrix;
+    }
+
+    RouteResult plan_route(const Maze& maze, const std::vector<std::pair<int, int>>& waypoints, const unsigned threads) {
+        RouteResult result;
+        std::vector<std::pair<int, int>> points = {maze.get_entrance()};
+        points.insert(points.end(), waypoints.begin(), waypoints.end());
+        points.push_back(maze.get_exit());
+        const size_t n = points.size();
+
+        auto start = std::chrono::steady_clock::now();
+        const auto matrix = distance_matrix(maze, points, threads);
+        result.matrix_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        result.exact = waypoints.size() <= EXACT_ROUTE_WAYPOINTS;
+        std::vector<size_t> stops;
+        if (waypoints.empty()) {
+            stops = {0, 1};
+        } else {
+            stops = result.exact ? exact_order(matrix, n) : heuristic_order(matrix, n);
+        }
+        result.length = route_length(matrix, n, stops);
+        if (result.length == NO_ROUTE)
+            throw std::runtime_error("The exit cannot be reached");
+        result.order_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (const size_t stop : stops) {
+            result.stops.push_back(points[stop]);
+            if (stop != 0 && stop != n - 1) result.order.push_back(stop - 1);
+        }
+
+        // Each leg starts where the previous one ended
+        Astar astar(maze);
+        result.path.push_back(result.stops.front());
+        for (size_t i = 0; i + 1 < result.stops.size(); i++) {
+            const PathCodec leg = astar.find_path(result.stops[i], result.stops[i + 1]);
+            if (leg.empty())
+                throw std::logic_error("Route leg has no path");
+            for (size_t m = 0; m + 1 < leg.size(); m++)
+                result.path.push_move(leg.move_at(m));
+        }
+        return result;
+    }
+}
@@ -0,0 +1,233 @@
+//
+// Single-pass row pipeline: one producer feeds many sinks, optionally on another thread
+//
+
+#include <rowpipeline.h>
+
+#include <algorithm>
+#include <maze.h>
+#include <splitmix.h>
+#include <stdexcept>
+#include <tiled.h>
+
+namespace course {
+    void TextFileSink::begin(const MazeShape& shape) {
+        file_ = std::ofstream(filename_);
+        if (!file_.is_open()) {
+            throw std::runtime_error("Could not open file for writing: " + filename_);
+        }
+        file_ << shape.rows << " " << shape.cols << "\n";
+        shape_ = shape;
+        bottom_.clear();
+        bottom_.reserve(static_cast<size_t>(shape.rows) * (shape.cols * 2 + 1));
+    }
+
+    void TextFileSink::consume(const WallRow& row) {
+        std::string line;
+        line.reserve(row.cols * 2 + 1);
+        for (int j = 0; j < row.cols; j++) {
+            line += row.vWalls[j] ? "1 " : "0 ";
+            bottom_ += row.hWalls[j] ? "1 " : "0 ";
+        }
+        line += "\n";
+        bottom_ += "\n";
+        file_ << line;
+    }
+
+    void TextFileSink::finish() {
+        file_ << "\n" << bottom_ << endpoint_lines(shape_);
+        file_.close();
+        if (file_.fail()) {
+            throw std::runtime_error("Could not write file: " + filename_);
+        }
+    }
+
+    TiledFileSink::TiledFileSink(std::string filename, const int tile_size)
+        : filename_(std::move(filename)), tile_(tile_size) {}
+
+    TiledFileSink::~TiledFileSink() = default;
+
+    void TiledFileSink::begin(const MazeShape& shape) {
+        writer_ = std::make_unique<TiledMazeWriter>(filename_, shape.rows, shape.cols, tile_);
+        writer_->set_entrance(shape.entrance.first, shape.entrance.second);
+        writer_->set_exit(shape.exit.first, shape.exit.second);
+        for (const auto& [row, col] : shape.extra_exits)
+            writer_->add_exit(row, col);
+    }
+
+    void TiledFileSink::consume(const WallRow& row) {
+        writer_->push_row(row.vWalls, row.hWalls);
+    }
+
+    void TiledFileSink::finish() {
+        writer_->finish();
+        writer_.reset();
+    }
+
+    // Walls are packed 64 per word and mixed word by word, then finalized (SplitMix64)
+    void HashSink::mix(const std::uint64_t word) {
+        hash_ = (hash_ ^ word) * SPLITMIX64_GAMMA;
+        hash_ ^= hash_ >> 29;
+    }
+
+    void HashSink::begin(const MazeShape& shape) {
+        shape_ = shape;
+        hash_ = 0x4D5A4531ULL;
+        word_ = 0;
+        bits_ = 0;
+        bottom_.clear();
+        bottom_.reserve((static_cast<size_t>(shape.rows) * shape.cols + 63) / 64);
+        bottomBits_ = 0;
+        mix(static_cast<std::uint64_t>(shape.rows) << 32 | static_cast<std::uint32_t>(shape.cols));
+    }
+
+    void HashSink::consume(const WallRow& row) {
+        for (int c = 0; c < row.cols; c++) {
+            word_ |= static_cast<std::uint64_t>(row.vWalls[c]) << bits_;
+            if (++bits_ == 64) {
+                mix(word_);
+                word_ = 0;
+                bits_ = 0;
+            }
+
+            if ((bottomBits_ & 63) == 0) bottom_.push_back(0);
+            bottom_.back() |= static_cast<std::uint64_t>(row.hWalls[c]) << (bottomBits_ & 63);
+            bottomBits_++;
+        }
+    }
+
+    void HashSink::finish() {
+        mix(word_ ^ static_cast<std::uint64_t>(bits_) << 56);
+
+        const size_t full = bottomBits_ / 64;
+        for (size_t w = 0; w < full; w++)
+            mix(bottom_[w]);
+        const int rest = static_cast<int>(bottomBits_ & 63);
+        mix((rest ? bottom_[full] : 0) ^ static_cast<std::uint64_t>(rest) << 56);
+
+        mix(static_cast<std::uint64_t>(shape_.entrance.first) << 32 |
+            static_cast<std::uint32_t>(shape_.entrance.second));
+        mix(static_cast<std::uint64_t>(shape_.exit.first) << 32 | static_cast<std::uint32_t>(shape_.exit.second));
+        for (const auto& [row, col] : shape_.extra_exits)
+            mix(static_cast<std::uint64_t>(row) << 32 | static_cast<std::uint32_t>(col));
+
+        hash_ = splitmix64_mix(hash_);
+    }
+
+    void StatsSink::begin(const MazeShape& shape) {
+        shape_ = shape;
+        stats_ = {};
+        openAbove_.assign(shape.cols, 0);
+    }
+
+    // The outer border counts as closed even where the entrance or exit opens it
+    void StatsSink::consume(const WallRow& row) {
+        const int cols = row.cols;
+        const bool last = row.index == shape_.rows - 1;
+        for (int c = 0; c < cols; c++) {
+            const bool right = c < cols - 1 && !row.vWalls[c];
+            const bool down = !last && !row.hWalls[c];
+            const bool left = c > 0 && !row.vWalls[c - 1];
+            const int degree = openAbove_[c] + left + right + down;
+
+            stats_.cells++;
+            stats_.open_edges += right + down;
+            if (degree == 1) stats_.dead_ends++;
+            else if (degree == 2) stats_.corridors++;
+            else if (degree >= 3) stats_.junctions++;
+            openAbove_[c] = down;
+        }
+    }
+
+    AsyncRowSink::AsyncRowSink(std::vector<RowSink*> downstream, const size_t capacity)
+        : downstream_(std::move(downstream)), slots_(std::max<size_t>(capacity, 1)) {}
+
+    AsyncRowSink::~AsyncRowSink() {
+        stop();
+    }
+
+    void AsyncRowSink::begin(const MazeShape& shape) {
+        cols_ = shape.cols;
+        for (auto& slot : slots_)
+            slot.walls = std::make_unique<bool[]>(static_cast<size_t>(cols_) * 2);
+        head_ = tail_ = 0;
+        closed_ = false;
+        error_ = nullptr;
+
+        for (RowSink* sink : downstream_)
+            sink->begin(shape);
+        worker_ = std::thread(&AsyncRowSink::run, this);
+    }
+
+    // Producer side: waits only while the ring is full
+    void AsyncRowSink::consume(const WallRow& row) {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [this] { return tail_ - head_ < slots_.size() || error_; });
+        if (error_) {
+            lock.unlock();
+            finish();
+            return;
+        }
+
+        Slot& slot = slots_[tail_ % slots_.size()];
+        slot.index = row.index;
+        std::copy_n(row.vWalls, cols_, slot.walls.get());
+        std::copy_n(row.hWalls, cols_, slot.walls.get() + cols_);
+        tail_++;
+        lock.unlock();
+        changed_.notify_all();
+    }
+
+    // Consumer side: rows are handed on without holding the lock
+    void AsyncRowSink::run() {
+        try {
+            while (true) {
+                std::unique_lock lock(mutex_);
+                changed_.wait(lock, [this] { return head_ < tail_ || closed_; });
+                if (head_ == tail_) return;
+                const Slot& slot = slots_[head_ % slots_.size()];
+                lock.unlock();
+
+                const WallRow row{slot.index, cols_, slot.walls.get(), slot.walls.get() + cols_};
+                for (RowSink* sink : downstream_)
+                    sink->consume(row);
+
+                lock.lock();
+                head_++;
+                lock.unlock();
+                changed_.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            error_ = std::current_exception();
+            changed_.notify_all();
+        }
+    }
+
+    void AsyncRowSink::stop() {
+        {
+            std::lock_guard lock(mutex_);
+            closed_ = true;
+        }
+        changed_.notify_all();
+        if (worker_.joinable()) worker_.join();
+    }
+
+    void AsyncRowSink::finish() {
+        stop();
+        if (error_) std::rethrow_exception(error_);
+        for (RowSink* sink : downstream_)
+            sink->finish();
+    }
+
+    void run_pipeline(RowStream rows, const MazeShape& shape, const std::vector<RowSink*>& sinks) {
+        for (RowSink* sink : sinks)
+            sink->begin(shape);
+        while (rows.next()) {
+            for (RowSink* sink : sinks)
+                sink->consume(rows.row());
+        }
+        for (RowSink* sink : sinks)
+            sink->finish();
+    }
+}
@@ -0,0 +1,89 @@
+//
+// Grid search core templated over cost type, heuristic, neighbour model and storage
+//
+
+#include <searchcore.h>
+
+#include <splitmix.h>
+#include <stdexcept>
+#include <threadpool.h>
+
+namespace course {
+    template class SearchCore<std::uint32_t, search::ZeroHeuristic, search::UnitNeighbors, search::DenseStorage>;
+    template class SearchCore<std::uint32_t, search::ManhattanHeuristic, search::UnitNeighbors, search::DenseStorage>;
+    template class SearchCore<std::uint32_t, search::ManhattanHeuristic, search::WeightedNeighbors, search::DenseStorage>;
+    template class SearchCore<std::uint32_t, search::ManhattanHeuristic, search::UnitNeighbors, search::HashStorage>;
+    template class SearchCore<std::uint32_t, search::LandmarkHeuristic, search::UnitNeighbors, search::DenseStorage>;
+
+    OpenGrid::OpenGrid(const Maze& maze, ThreadPool* pool) : rows(maze.getRows()), cols(maze.getCols()) {
+        const auto& vWalls = maze.get_v_walls();
+        const auto& hWalls = maze.get_h_walls();
+        open.resize(static_cast<size_t>(rows) * cols);
+        const auto decode_row = [&](const size_t i) {
+            const int r = static_cast<int>(i);
+            std::uint8_t* out = &open[i * cols];
+            for (int c = 0; c < cols; c++) {
+                std::uint8_t sides = 0;
+                if (r > 0 && !hWalls(r - 1, c)) sides |= Up;
+                if (r < rows - 1 && !hWalls(r, c)) sides |= Down;
+                if (c > 0 && !vWalls(r, c - 1)) sides |= Left;
+                if (c < cols - 1 && !vWalls(r, c)) sides |= Right;
+                out[c] = sides;
+            }
+        };
+
+        if (pool) {
+            pool->parallel_for(static_cast<size_t>(rows), decode_row);
+        } else {
+            for (size_t i = 0; i < static_cast<size_t>(rows); i++) decode_row(i);
+        }
+    }
+
+    PolicySolver::PolicySolver(const Maze& maze, const std::uint64_t weight_seed, const int max_weight)
+        : maze_(maze), grid_(maze), weights_(grid_.cells()),
+          bfs_({&grid_}), astar_({&grid_}), weighted_({&grid_, &weights_}), sparse_({&grid_}),
+          alt_({&grid_}) {
+        if (max_weight < 1 || max_weight > 255) throw std::invalid_argument("Cell weights must be in 1..255");
+
+        // SplitMix64 over the cell index: the same seed always gives the same weights
+        for (size_t i = 0; i < weights_.size(); i++) {
+            const std::uint64_t z = splitmix64_mix(weight_seed + (i + 1) * SPLITMIX64_GAMMA);
+            weights_[i] = static_cast<std::uint8_t>(1 + z % max_weight);
+        }
+    }
+
+    const std::vector<std::string>& PolicySolver::names() {
+        static const std::vector<std::string> names = {"bfs", "astar", "weighted", "astar_sparse", "alt"};
+        return names;
+    }
+
+    void PolicySolver::use_landmarks(const int count, const unsigned threads, const Landmarks::Selection selection) {
+        landmarks_ = std::make_unique<Landmarks>(maze_, count, threads, selection);
+        alt_ = search::AltAstar({&grid_}, search::LandmarkHeuristic(landmarks_.get()));
+    }
+
+    PolicySolver::Result PolicySolver::solve(const std::string& name, const std::pair<int, int>& start,
+                                             const std::pair<int, int>& goal) {
+        const auto inside = [this](const std::pair<int, int>& cell) {
+            return cell.first >= 0 && cell.first < grid_.rows && cell.second >= 0 && cell.second < grid_.cols;
+        };
+        if (!inside(start) || !inside(goal)) throw std::out_of_range("Path endpoint outside the maze");
+
+        Result result;
+        auto run = [&](auto& solver) {
+            result.path = solver.find_path(start, goal);
+            result.cost = solver.cost();
+            result.expanded = solver.expanded();
+        };
+        if (name == "bfs") run(bfs_);
+        else if (name == "astar") run(astar_);
+        else if (name == "weighted") run(weighted_);
+        else if (name == "astar_sparse") run(sparse_);
+        else if (name == "alt") {
+            if (!landmarks_) use_landmarks(8);
+            run(alt_);
+        }
+        else throw std::invalid_argument("Unknown solver '" + name + "'");
+        return result;
+    }
+}
@@ -0,0 +1,142 @@
+//
+// On-disk cache of solved paths keyed by maze content hash and endpoints
+//
+
+#include <solutioncache.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <ios>
+#include <maze.h>
+#include <sstream>
+#include <stdexcept>
+
+namespace course {
+    namespace {
+        constexpr char MAGIC[] = "MZC2";
+    }
+
+    SolutionCache::SolutionCache(std::string filename, const size_t max_entries)
+        : filename_(std::move(filename)), maxEntries_(std::max<size_t>(max_entries, 1)) {}
+
+    SolutionCache::~SolutionCache() {
+        try {
+            flush();
+        } catch (...) {
+            // Losing cached solutions only costs a solve next time
+        }
+    }
+
+    SolutionCache::Key SolutionCache::key_of(const Maze& maze) {
+        return {maze.content_hash(), maze.get_entrance(), maze.get_exit()};
+    }
+
+    // Header: magic and recency clock; one line per entry:
+    // hash start goal last_used seconds runs path_record
+    void SolutionCache::load() {
+        if (loaded_) return;
+        loaded_ = true;
+
+        std::ifstream file(filename_);
+        std::string magic;
+        if (!(file >> magic >> clock_) || magic != MAGIC) {
+            clock_ = 0;
+            return;
+        }
+        file.ignore();
+
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream in(line);
+            Entry entry;
+            if (!(in >> std::hex >> entry.key.maze_hash >> std::dec
+                     >> entry.key.start.first >> entry.key.start.second
+                     >> entry.key.goal.first >> entry.key.goal.second
+                     >> entry.last_used >> entry.seconds >> entry.runs)) {
+                continue; // Skip damaged lines
+            }
+            in >> std::ws;
+            std::getline(in, entry.record);
+            entries_.push_back(std::move(entry));
+        }
+    }
+
+    std::optional<SolutionCache::Solution> SolutionCache::find(const Key& key) {
+        load();
+        const auto it = std::ranges::find(entries_, key, &Entry::key);
+        if (it == entries_.end()) {
+            misses_++;
+            return std::nullopt;
+        }
+
+        Solution solution;
+        try {
+            std::istringstream in(it->record);
+            solution.path.read(in);
+        } catch (const std::invalid_argument&) {
+            entries_.erase(it);
+            dirty_ = true;
+            misses_++;
+            return std::nullopt;
+        }
+
+        // Recency is kept in memory only: a hit never rewrites the file, and the next
+        // store persists it along with the new entry
+        it->last_used = ++clock_;
+        solution.seconds = it->seconds;
+        solution.runs = it->runs;
+        hits_++;
+        return solution;
+    }
+
+    void SolutionCache::store(const Key& key, const PathCodec& path, const double seconds, const std::uint32_t runs) {
+        load();
+        std::ostringstream record;
+        path.write(record);
+
+        const auto it = std::ranges::find(entries_, key, &Entry::key);
+        Entry& entry = it != entries_.end() ? *it : entries_.emplace_back();
+        entry.key = key;
+        entry.last_used = ++clock_;
+        entry.seconds = seconds;
+        entry.runs = runs;
+        entry.record = record.str();
+
+        if (entries_.size() > maxEntries_) {
+            entries_.erase(std::ranges::min_element(entries_, {}, &Entry::last_used));
+        }
+        dirty_ = true;
+    }
+
+    size_t SolutionCache::size() {
+        load();
+        return entries_.size();
+    }
+
+    // Written to a side file and renamed, so readers never see half a cache
+    void SolutionCache::flush() {
+        if (!dirty_) return;
+
+        const std::string temp = filename_ + ".tmp";
+        {
+            std::ofstream file(temp);
+            if (!file.is_open()) {
+                throw std::runtime_error("Cannot write solution cache: " + temp);
+            }
+            file << MAGIC << " " << clock_ << "\n";
+            for (const Entry& entry : entries_) {
+                file << std::hex << entry.key.maze_hash << std::dec
+                     << " " << entry.key.start.first << " " << entry.key.start.second
+                     << " " << entry.key.goal.first << " " << entry.key.goal.second
+                     << " " << entry.last_used << " " << entry.seconds << " " << entry.runs
+                     << " " << entry.record << "\n";
+            }
+        }
+        if (std::rename(temp.c_str(), filename_.c_str()) != 0) {
+            std::remove(temp.c_str());
+            throw std::runtime_error("Cannot replace solution cache: " + filename_);
+        }
+        dirty_ = false;
+    }
+}
@@ -0,0 +1,92 @@
+//
+// Parallel candidate generation until a maze meets a difficulty target
+//
+
+#include <targetgen.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <distance.h>
+#include <generator.h>
+#include <mutex>
+#include <splitmix.h>
+#include <threadpool.h>
+
+namespace course {
+    namespace {
+        bool meets(const MazeAnalysis& analysis, const TargetOptions& options) {
+            if (analysis.solution_length == MazeAnalysis::NONE || analysis.solution_length < options.min_path)
+                return false;
+            return static_cast<double>(analysis.dead_ends) >= options.min_dead_ends * static_cast<double>(analysis.cells);
+        }
+    }
+
+    // SplitMix64 finalizer over the pair, so neighbouring indices get unrelated seeds
+    std::uint64_t candidate_seed(const std::uint64_t base, const std::uint64_t candidate) {
+        return splitmix64_mix(base + (candidate + 1) * SPLITMIX64_GAMMA);
+    }
+
+    TargetResult generate_target(Maze& maze, const int rows, const int cols, const TargetOptions& options) {
+        const auto start = std::chrono::steady_clock::now();
+        // Fails early on an unknown algorithm name
+        const auto generator = GeneratorRegistry::instance().create(options.algo);
+
+        std::atomic<std::uint64_t> next{0};
+        // Lowest matching index so far; no candidate at or past it is started
+        std::atomic<std::uint64_t> winner{options.max_candidates};
+        std::atomic<std::uint64_t> scored{0};
+        std::mutex mutex;
+        TargetResult result;
+
+        ThreadPool pool(options.threads);
+        pool.run_on_all([&](unsigned) {
+            Maze candidate;
+            std::uint64_t best = 0;
+            while (true) {
+                const std::uint64_t index = next.fetch_add(1);
+                if (index >= winner.load()) break;
+
+                candidate.set_sizes(rows, cols);
+                candidate.clear_gen();
+                generator->generate(candidate, candidate_seed(options.seed, index), 1);
+                if (options.farthest) {
+                    const auto [entrance, exit] = farthest_border_pair(candidate);
+                    candidate.move_entrance_exit(entrance, exit);
+                }
+                const MazeAnalysis analysis = analyze_maze(candidate, 1);
+                scored.fetch_add(1);
+                if (analysis.solution_length != MazeAnalysis::NONE)
+                    best = std::max(best, analysis.solution_length);
+
+                if (meets(analysis, options)) {
+                    std::lock_guard lock(mutex);
+                    if (index < winner.load()) {
+                        winner.store(index);
+                        result.analysis = analysis;
+                    }
+                }
+            }
+
+            std::lock_guard lock(mutex);
+            result.best_path = std::max(result.best_path, best);
+        });
+
+        result.scored = scored.load();
+        result.found = winner.load() < options.max_candidates;
+        if (result.found) {
+            // Regenerating one candidate is cheaper than copying every improvement out
+            result.candidate = winner.load();
+            result.seed = candidate_seed(options.seed, result.candidate);
+            maze.set_sizes(rows, cols);
+            maze.clear_gen();
+            generator->generate(maze, result.seed, 1);
+            if (options.farthest) {
+                const auto [entrance, exit] = farthest_border_pair(maze);
+                maze.move_entrance_exit(entrance, exit);
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+}
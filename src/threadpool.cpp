@@ -0,0 +1,85 @@
+//
+// Fixed set of worker threads reused across parallel phases
+//
+
+#include <threadpool.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace course {
+    ThreadPool::ThreadPool(const unsigned threads) {
+        for (unsigned id = 1; id < std::max(threads, 1u); id++)
+            workers_.emplace_back(&ThreadPool::worker_loop, this, id);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    void ThreadPool::worker_loop(const unsigned id) {
+        unsigned long seen = 0;
+        while (true) {
+            const std::function<void(unsigned)>* task;
+            {
+                std::unique_lock lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+                task = task_;
+            }
+
+            try {
+                (*task)(id);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+
+            std::lock_guard lock(mutex_);
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    void ThreadPool::run_on_all(const std::function<void(unsigned)>& fn) {
+        if (workers_.empty()) {
+            fn(0);
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            task_ = &fn;
+            error_ = nullptr;
+            pending_ = static_cast<unsigned>(workers_.size());
+            generation_++;
+        }
+        start_.notify_all();
+
+        std::exception_ptr error;
+        try {
+            fn(0);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [&] { return pending_ == 0; });
+        if (!error) error = error_;
+        if (error) std::rethrow_exception(error);
+    }
+
+    void ThreadPool::parallel_for(const size_t count, const std::function<void(size_t)>& fn) {
+        std::atomic<size_t> next{0};
+        run_on_all([&](unsigned) {
+            for (size_t i = next++; i < count; i = next++)
+                fn(i);
+        });
+    }
+}
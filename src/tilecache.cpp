@@ -0,0 +1,53 @@
+//
+// Bounded LRU cache of wall tiles over a tiled maze file
+//
+
+#include <tilecache.h>
+
+#include <algorithm>
+
+namespace course {
+    TileCache::TileCache(TiledMazeReader& reader, const size_t capacity_bytes)
+        : reader_(reader), capacity_(capacity_bytes) {}
+
+    const WallTile& TileCache::tile_for(const int row, const int col) {
+        const int ty = row / reader_.tile_size();
+        const int tx = col / reader_.tile_size();
+        const std::int64_t key = static_cast<std::int64_t>(ty) * reader_.tiles_x() + tx;
+
+        if (key == lastKey_) {
+            stats_.hits++;
+            return *last_;
+        }
+
+        if (const auto it = index_.find(key); it != index_.end()) {
+            stats_.hits++;
+            lru_.splice(lru_.begin(), lru_, it->second);
+        } else {
+            stats_.misses++;
+            lru_.emplace_front(key, reader_.load_tile(ty, tx));
+            index_[key] = lru_.begin();
+            bytes_ += lru_.front().second.memory_bytes();
+
+            // Evict least recently used tiles, always keeping the one just loaded
+            while (bytes_ > capacity_ && lru_.size() > 1) {
+                bytes_ -= lru_.back().second.memory_bytes();
+                index_.erase(lru_.back().first);
+                lru_.pop_back();
+                stats_.evictions++;
+            }
+            stats_.peak_bytes = std::max(stats_.peak_bytes, bytes_);
+        }
+
+        const WallTile& tile = lru_.front().second;
+        lastKey_ = key;
+        last_ = &tile;
+        return tile;
+    }
+
+    TileCacheStats TileCache::stats() const {
+        TileCacheStats result = stats_;
+        result.bytes_read = reader_.bytes_read();
+        return result;
+    }
+}
@@ -0,0 +1,360 @@
+//
+// Tiled, compressed on-disk maze format with random access to regions
+//
+
+#include <tiled.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <generator.h>
+#include <memory>
+#include <rowpipeline.h>
+#include <stdexcept>
+
+namespace course {
+    namespace {
+        static_assert(std::endian::native == std::endian::little, "Tiled format assumes a little-endian host");
+
+        constexpr char MAGIC[4] = {'M', 'Z', 'T', '1'};
+        constexpr char FOOTER_MAGIC[4] = {'M', 'Z', 'X', '1'};
+        constexpr size_t HEADER_SIZE = 32;
+        constexpr size_t ENTRY_SIZE = 16;
+
+        template <typename T>
+        void put(std::uint8_t* out, const T value) {
+            std::memcpy(out, &value, sizeof(T));
+        }
+
+        template <typename T>
+        T get(const std::uint8_t* in) {
+            T value;
+            std::memcpy(&value, in, sizeof(T));
+            return value;
+        }
+
+        // Pack one row of bools into 64-bit words
+        void pack_row(const bool* row, const int cols, std::uint64_t* out) {
+            for (int j = 0; j < cols; j += 64) {
+                std::uint64_t word = 0;
+                const int end = std::min(64, cols - j);
+                for (int b = 0; b < end; b++)
+                    word |= static_cast<std::uint64_t>(row[j + b]) << b;
+                out[j >> 6] = word;
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> TileCodec::compress(const std::uint8_t* data, const size_t size) {
+        // Control byte 0..127: copy next c + 1 bytes; 128..255: repeat next byte c - 125 times
+        std::vector<std::uint8_t> out;
+        out.reserve(size / 2 + 16);
+
+        auto run_at = [&](const size_t pos) {
+            size_t run = 1;
+            while (pos + run < size && run < 130 && data[pos + run] == data[pos]) run++;
+            return run;
+        };
+
+        size_t i = 0;
+        while (i < size) {
+            if (const size_t run = run_at(i); run >= 3) {
+                out.push_back(static_cast<std::uint8_t>(128 + run - 3));
+                out.push_back(data[i]);
+                i += run;
+                continue;
+            }
+
+            const size_t start = i;
+            while (i < size && i - start < 128 && run_at(i) < 3) i++;
+            out.push_back(static_cast<std::uint8_t>(i - start - 1));
+            out.insert(out.end(), data + start, data + i);
+        }
+        return out;
+    }
+
+    void TileCodec::decompress(const std::uint8_t* data, const size_t size, std::uint8_t* out, const size_t out_size) {
+        size_t i = 0;
+        size_t o = 0;
+        while (i < size) {
+            const std::uint8_t control = data[i++];
+            if (control < 128) {
+                const size_t count = control + 1;
+                if (i + count > size || o + count > out_size)
+                    throw std::runtime_error("Corrupt tile payload");
+                std::memcpy(out + o, data + i, count);
+                i += count;
+                o += count;
+            } else {
+                const size_t count = control - 125;
+                if (i >= size || o + count > out_size)
+                    throw std::runtime_error("Corrupt tile payload");
+                std::memset(out + o, data[i++], count);
+                o += count;
+            }
+        }
+        if (o != out_size)
+            throw std::runtime_error("Corrupt tile payload");
+    }
+
+    TiledMazeWriter::TiledMazeWriter(const std::string& filename, const int rows, const int cols, const int tile_size)
+        : rows_(rows), cols_(cols), tile_(tile_size), entrance_{0, 0}, exit_{rows - 1, cols - 1} {
+        if (rows <= 0 || cols <= 0)
+            throw std::invalid_argument("Wrong maze size");
+        if (tile_size < 64 || tile_size % 64 != 0)
+            throw std::invalid_argument("Tile size must be a positive multiple of 64");
+
+        file_ = std::ofstream(filename, std::ios::binary | std::ios::trunc);
+        if (!file_.is_open())
+            throw std::runtime_error("Could not open file for writing: " + filename);
+
+        tilesX_ = (cols + tile_ - 1) / tile_;
+        tilesY_ = (rows + tile_ - 1) / tile_;
+        rowWords_ = (cols + 63) / 64;
+        vBand_.assign(static_cast<size_t>(tile_) * rowWords_, 0);
+        hBand_.assign(static_cast<size_t>(tile_) * rowWords_, 0);
+        directory_.assign(static_cast<size_t>(tilesX_) * tilesY_ * ENTRY_SIZE, 0);
+
+        // Reserve header and directory, both are rewritten by finish()
+        const std::vector<char> placeholder(HEADER_SIZE + directory_.size(), 0);
+        file_.write(placeholder.data(), static_cast<std::streamsize>(placeholder.size()));
+    }
+
+    void TiledMazeWriter::push_row(const bool* vWalls, const bool* hWalls) {
+        if (rowsWritten_ + bandRows_ >= rows_)
+            throw std::logic_error("Too many rows pushed to tiled writer");
+
+        const size_t offset = static_cast<size_t>(bandRows_) * rowWords_;
+        pack_row(vWalls, cols_, &vBand_[offset]);
+        pack_row(hWalls, cols_, &hBand_[offset]);
+        if (++bandRows_ == tile_)
+            flush_band();
+    }
+
+    // Cut the buffered band into tiles and append each compressed payload
+    void TiledMazeWriter::flush_band() {
+        if (bandRows_ == 0) return;
+
+        const int tileRow = rowsWritten_ / tile_;
+        std::vector<std::uint8_t> raw;
+        for (int tx = 0; tx < tilesX_; tx++) {
+            const int width = std::min(tile_, cols_ - tx * tile_);
+            const int stride = (width + 63) / 64;
+            const int firstWord = tx * tile_ / 64;
+            const size_t planeBytes = static_cast<size_t>(bandRows_) * stride * sizeof(std::uint64_t);
+
+            raw.resize(2 * planeBytes);
+            for (int r = 0; r < bandRows_; r++) {
+                const size_t src = static_cast<size_t>(r) * rowWords_ + firstWord;
+                const size_t dst = static_cast<size_t>(r) * stride * sizeof(std::uint64_t);
+                std::memcpy(&raw[dst], &vBand_[src], stride * sizeof(std::uint64_t));
+                std::memcpy(&raw[planeBytes + dst], &hBand_[src], stride * sizeof(std::uint64_t));
+            }
+
+            auto packed = TileCodec::compress(raw.data(), raw.size());
+            auto method = TileCodec::RunLength;
+            if (packed.size() >= raw.size()) {
+                packed = raw;
+                method = TileCodec::Stored;
+            }
+
+            std::uint8_t* entry = &directory_[(static_cast<size_t>(tileRow) * tilesX_ + tx) * ENTRY_SIZE];
+            put<std::uint64_t>(entry, static_cast<std::uint64_t>(file_.tellp()));
+            put<std::uint32_t>(entry + 8, static_cast<std::uint32_t>(packed.size()));
+            entry[12] = method;
+            file_.write(reinterpret_cast<const char*>(packed.data()), static_cast<std::streamsize>(packed.size()));
+        }
+
+        rowsWritten_ += bandRows_;
+        bandRows_ = 0;
+        std::ranges::fill(vBand_, 0);
+        std::ranges::fill(hBand_, 0);
+    }
+
+    void TiledMazeWriter::finish() {
+        flush_band();
+        if (rowsWritten_ != rows_)
+            throw std::logic_error("Tiled writer finished before all rows were pushed");
+
+        if (!extraExits_.empty()) {
+            std::vector<std::uint8_t> footer(8 + extraExits_.size() * 8);
+            std::memcpy(footer.data(), FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+            put<std::int32_t>(&footer[4], static_cast<std::int32_t>(extraExits_.size()));
+            for (size_t i = 0; i < extraExits_.size(); i++) {
+                put<std::int32_t>(&footer[8 + i * 8], extraExits_[i].first);
+                put<std::int32_t>(&footer[12 + i * 8], extraExits_[i].second);
+            }
+            file_.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+        }
+
+        std::uint8_t header[HEADER_SIZE] = {};
+        std::memcpy(header, MAGIC, sizeof(MAGIC));
+        put<std::int32_t>(header + 4, rows_);
+        put<std::int32_t>(header + 8, cols_);
+        put<std::int32_t>(header + 12, tile_);
+        put<std::int32_t>(header + 16, entrance_.first);
+        put<std::int32_t>(header + 20, entrance_.second);
+        put<std::int32_t>(header + 24, exit_.first);
+        put<std::int32_t>(header + 28, exit_.second);
+
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+        file_.write(reinterpret_cast<const char*>(directory_.data()), static_cast<std::streamsize>(directory_.size()));
+        file_.close();
+        if (file_.fail())
+            throw std::runtime_error("Could not write tiled maze");
+    }
+
+    TiledMazeReader::TiledMazeReader(const std::string& filename) {
+        file_ = std::ifstream(filename, std::ios::binary);
+        if (!file_.is_open())
+            throw std::runtime_error("Could not open file: " + filename);
+
+        std::uint8_t header[HEADER_SIZE];
+        read_bytes(0, header, HEADER_SIZE, false);
+        if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::invalid_argument("Not a tiled maze file: " + filename);
+
+        rows_ = get<std::int32_t>(header + 4);
+        cols_ = get<std::int32_t>(header + 8);
+        tile_ = get<std::int32_t>(header + 12);
+        entrance_ = {get<std::int32_t>(header + 16), get<std::int32_t>(header + 20)};
+        exit_ = {get<std::int32_t>(header + 24), get<std::int32_t>(header + 28)};
+        if (rows_ <= 0 || cols_ <= 0 || tile_ < 64 || tile_ % 64 != 0)
+            throw std::invalid_argument("Wrong tiled maze header");
+
+        tilesX_ = (cols_ + tile_ - 1) / tile_;
+        tilesY_ = (rows_ + tile_ - 1) / tile_;
+        read_footer();
+    }
+
+    // Payloads are written in directory order, so the footer starts where the last one ends
+    void TiledMazeReader::read_footer() {
+        std::uint8_t entry[ENTRY_SIZE];
+        read_bytes(HEADER_SIZE + (static_cast<std::uint64_t>(tilesX_) * tilesY_ - 1) * ENTRY_SIZE, entry, ENTRY_SIZE,
+                   false);
+        const std::uint64_t end = get<std::uint64_t>(entry) + get<std::uint32_t>(entry + 8);
+
+        file_.seekg(0, std::ios::end);
+        if (static_cast<std::uint64_t>(file_.tellg()) <= end) return;
+
+        std::uint8_t head[8];
+        read_bytes(end, head, sizeof(head), false);
+        const auto count = get<std::int32_t>(head + 4);
+        if (std::memcmp(head, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) != 0 || count < 0)
+            throw std::invalid_argument("Wrong tiled maze footer");
+
+        std::vector<std::uint8_t> cells(static_cast<size_t>(count) * 8);
+        read_bytes(end + sizeof(head), cells.data(), cells.size(), false);
+        for (size_t i = 0; i < cells.size(); i += 8)
+            extraExits_.emplace_back(get<std::int32_t>(&cells[i]), get<std::int32_t>(&cells[i + 4]));
+    }
+
+    void TiledMazeReader::read_bytes(const std::uint64_t offset, std::uint8_t* out, const size_t size, const bool counted) {
+        file_.seekg(static_cast<std::streamoff>(offset));
+        file_.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(size));
+        if (static_cast<size_t>(file_.gcount()) != size)
+            throw std::runtime_error("Unexpected end of tiled maze file");
+        if (counted) bytesRead_ += size;
+    }
+
+    WallTile TiledMazeReader::load_tile(const int tile_row, const int tile_col) {
+        if (tile_row < 0 || tile_row >= tilesY_ || tile_col < 0 || tile_col >= tilesX_)
+            throw std::out_of_range("Tile index out of range");
+
+        std::uint8_t entry[ENTRY_SIZE];
+        read_bytes(HEADER_SIZE + (static_cast<std::uint64_t>(tile_row) * tilesX_ + tile_col) * ENTRY_SIZE,
+                   entry, ENTRY_SIZE);
+        const auto offset = get<std::uint64_t>(entry);
+        const auto size = get<std::uint32_t>(entry + 8);
+        const auto method = entry[12];
+
+        WallTile tile;
+        tile.row0 = tile_row * tile_;
+        tile.col0 = tile_col * tile_;
+        tile.rows = std::min(tile_, rows_ - tile.row0);
+        tile.cols = std::min(tile_, cols_ - tile.col0);
+        tile.stride = (tile.cols + 63) / 64;
+
+        const size_t words = static_cast<size_t>(tile.rows) * tile.stride;
+        const size_t planeBytes = words * sizeof(std::uint64_t);
+        std::vector<std::uint8_t> payload(size);
+        read_bytes(offset, payload.data(), size);
+
+        std::vector<std::uint8_t> raw(2 * planeBytes);
+        if (method == TileCodec::Stored) {
+            if (size != raw.size())
+                throw std::runtime_error("Corrupt tile payload");
+            raw = std::move(payload);
+        } else {
+            TileCodec::decompress(payload.data(), payload.size(), raw.data(), raw.size());
+        }
+
+        tile.vBits.resize(words);
+        tile.hBits.resize(words);
+        std::memcpy(tile.vBits.data(), raw.data(), planeBytes);
+        std::memcpy(tile.hBits.data(), raw.data() + planeBytes, planeBytes);
+        tilesRead_++;
+        return tile;
+    }
+
+    void TiledMazeReader::load_region(Maze& out, int row, int col, int rows, int cols) {
+        row = std::clamp(row, 0, rows_ - 1);
+        col = std::clamp(col, 0, cols_ - 1);
+        rows = std::clamp(rows, 1, rows_ - row);
+        cols = std::clamp(cols, 1, cols_ - col);
+
+        out.set_sizes(rows, cols);
+        auto& vWalls = out.get_v_walls();
+        auto& hWalls = out.get_h_walls();
+
+        for (int ty = row / tile_; ty <= (row + rows - 1) / tile_; ty++) {
+            for (int tx = col / tile_; tx <= (col + cols - 1) / tile_; tx++) {
+                const WallTile tile = load_tile(ty, tx);
+                const int r0 = std::max(row, tile.row0);
+                const int r1 = std::min(row + rows, tile.row0 + tile.rows);
+                const int c0 = std::max(col, tile.col0);
+                const int c1 = std::min(col + cols, tile.col0 + tile.cols);
+                for (int i = r0; i < r1; i++)
+                    for (int j = c0; j < c1; j++) {
+                        vWalls(i - row, j - col) = tile.v_wall(i - tile.row0, j - tile.col0);
+                        hWalls(i - row, j - col) = tile.h_wall(i - tile.row0, j - tile.col0);
+                    }
+            }
+        }
+
+        auto inside = [&](const std::pair<int, int>& cell) {
+            return cell.first >= row && cell.first < row + rows && cell.second >= col && cell.second < col + cols;
+        };
+        if (inside(entrance_)) out.set_entrance(entrance_.first - row, entrance_.second - col);
+        if (inside(exit_)) out.set_exit(exit_.first - row, exit_.second - col);
+        for (const auto& cell : extraExits_)
+            if (inside(cell)) out.add_exit(cell.first - row, cell.second - col);
+    }
+
+    void save_tiled(Maze& maze, const std::string& filename, const int tile_size) {
+        TiledMazeWriter writer(filename, maze.getRows(), maze.getCols(), tile_size);
+        writer.set_entrance(maze.get_entrance().first, maze.get_entrance().second);
+        writer.set_exit(maze.get_exit().first, maze.get_exit().second);
+        for (const auto& [row, col] : maze.shape().extra_exits)
+            writer.add_exit(row, col);
+        for (int i = 0; i < maze.getRows(); i++)
+            writer.push_row(&maze.get_v_walls()(i, 0), &maze.get_h_walls()(i, 0));
+        writer.finish();
+    }
+
+    void generate_tiled(const Generator& generator, const int rows, const int cols, const std::uint64_t seed,
+                        const std::string& filename, const int tile_size, const unsigned threads) {
+        TiledFileSink file(filename, tile_size);
+        AsyncRowSink writer({&file});
+        if (generator.streams_rows()) {
+            run_pipeline(generator.stream_rows(rows, cols, seed), {rows, cols, {0, 0}, {rows - 1, cols - 1}, {}}, {&writer});
+            return;
+        }
+
+        Maze maze;
+        maze.set_sizes(rows, cols);
+        maze.clear_gen();
+        run_pipeline(generator.generate_rows(maze, seed, threads), maze.shape(), {&writer});
+    }
+}
@@ -0,0 +1,129 @@
+//
+// Out-of-core A* over a tiled maze, walls paged through a TileCache
+//
+
+#include <tiledsolver.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+
+namespace course {
+    namespace {
+        // Directions: up, down, left, right
+        constexpr int DR[4] = {-1, 1, 0, 0};
+        constexpr int DC[4] = {0, 0, -1, 1};
+        constexpr int OPPOSITE[4] = {1, 0, 3, 2};
+
+        struct OpenEntry {
+            std::int64_t f;
+            std::int64_t g;
+            int row;
+            int col;
+            int dir;
+
+            // Smallest f first, deeper nodes first on ties
+            bool operator>(const OpenEntry& other) const {
+                return f != other.f ? f > other.f : g < other.g;
+            }
+        };
+
+        std::int64_t manhattan(const int row, const int col, const std::pair<int, int>& goal) {
+            return std::abs(row - goal.first) + std::abs(col - goal.second);
+        }
+    }
+
+    TiledAstar::TileState& TiledAstar::state_for(const int row, const int col) {
+        const int tile = cache_.tile_size();
+        const std::int64_t key = static_cast<std::int64_t>(row / tile) * ((cache_.getCols() + tile - 1) / tile) + col / tile;
+
+        auto [it, inserted] = state_.try_emplace(key);
+        if (inserted) {
+            const size_t cells = static_cast<size_t>(tile) * tile;
+            it->second.closed.assign(cells / 64, 0);
+            it->second.parent.assign(cells / 32, 0);
+            stats_.state_bytes += (it->second.closed.size() + it->second.parent.size()) * sizeof(std::uint64_t);
+            stats_.state_tiles++;
+        }
+        return it->second;
+    }
+
+    bool TiledAstar::is_closed(const int row, const int col) {
+        const int tile = cache_.tile_size();
+        const size_t bit = static_cast<size_t>(row % tile) * tile + col % tile;
+        return state_for(row, col).closed[bit >> 6] >> (bit & 63) & 1;
+    }
+
+    void TiledAstar::close(const int row, const int col, const int dir) {
+        const int tile = cache_.tile_size();
+        const size_t bit = static_cast<size_t>(row % tile) * tile + col % tile;
+        auto& state = state_for(row, col);
+        state.closed[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+        state.parent[bit >> 5] |= static_cast<std::uint64_t>(dir) << ((bit & 31) * 2);
+    }
+
+    int TiledAstar::parent_dir(const int row, const int col) {
+        const int tile = cache_.tile_size();
+        const size_t bit = static_cast<size_t>(row % tile) * tile + col % tile;
+        return static_cast<int>(state_for(row, col).parent[bit >> 5] >> ((bit & 31) * 2) & 3);
+    }
+
+    bool TiledAstar::can_move(const int row, const int col, const int dir) {
+        switch (dir) {
+            case 0: return row > 0 && !cache_.h_wall(row - 1, col);
+            case 1: return row < cache_.getRows() - 1 && !cache_.h_wall(row, col);
+            case 2: return col > 0 && !cache_.v_wall(row, col - 1);
+            default: return col < cache_.getCols() - 1 && !cache_.v_wall(row, col);
+        }
+    }
+
+    PathCodec TiledAstar::find_path(const std::pair<int, int>& start,
+                                    const std::pair<int, int>& goal) {
+        state_.clear();
+        stats_ = Stats();
+
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<>> open_set;
+        open_set.push({manhattan(start.first, start.second, goal), 0, start.first, start.second, 0});
+
+        bool found = false;
+        while (!open_set.empty()) {
+            const OpenEntry current = open_set.top();
+            open_set.pop();
+
+            if (is_closed(current.row, current.col)) continue;
+            close(current.row, current.col, current.dir);
+            stats_.expanded++;
+
+            if (current.row == goal.first && current.col == goal.second) {
+                found = true;
+                break;
+            }
+
+            for (int dir = 0; dir < 4; dir++) {
+                if (!can_move(current.row, current.col, dir)) continue;
+                const int row = current.row + DR[dir];
+                const int col = current.col + DC[dir];
+                if (is_closed(row, col)) continue;
+                open_set.push({current.g + 1 + manhattan(row, col, goal), current.g + 1, row, col, dir});
+            }
+            stats_.peak_open = std::max(stats_.peak_open, open_set.size());
+        }
+
+        if (!found) return PathCodec();
+
+        // Walk arrival directions back from the goal, one byte per step, then replay them
+        std::vector<std::uint8_t> moves;
+        std::pair<int, int> cell = goal;
+        while (cell != start) {
+            const int dir = parent_dir(cell.first, cell.second);
+            moves.push_back(static_cast<std::uint8_t>(dir));
+            cell = {cell.first + DR[OPPOSITE[dir]], cell.second + DC[OPPOSITE[dir]]};
+        }
+
+        PathCodec path;
+        path.push_back(start);
+        for (auto it = moves.rbegin(); it != moves.rend(); ++it)
+            path.push_move(static_cast<PathCodec::Move>(*it));
+        return path;
+    }
+}
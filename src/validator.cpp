@@ -0,0 +1,189 @@
+//
+// Perfect-maze validation: edges, connectivity, cycles, borders and openings
+//
+
+#include <validator.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <ostream>
+
+namespace course {
+    namespace {
+        // Bit c set where the wall at column c is absent
+        void pack_open(const bool* walls, const int cols, std::vector<std::uint64_t>& out) {
+            std::ranges::fill(out, 0);
+            for (int c = 0; c < cols; c++)
+                out[c >> 6] |= static_cast<std::uint64_t>(!walls[c]) << (c & 63);
+        }
+
+        template <typename Fn>
+        void for_each_bit(const std::vector<std::uint64_t>& words, Fn fn) {
+            for (size_t w = 0; w < words.size(); w++) {
+                for (std::uint64_t bits = words[w]; bits; bits &= bits - 1)
+                    fn(static_cast<int>(w * 64 + std::countr_zero(bits)));
+            }
+        }
+
+        std::string cell_text(const std::pair<int, int>& cell) {
+            return "(" + std::to_string(cell.first) + ", " + std::to_string(cell.second) + ")";
+        }
+    }
+
+    RowValidator::RowValidator(const MazeShape& shape)
+        : shape_(shape), words_((std::max(shape.cols, 0) + 63) / 64), right_(words_), down_(words_),
+          prevLabel_(std::max(shape.cols, 0)), nextLabel_(std::max(shape.cols, 0)) {
+        report_.cells = static_cast<std::uint64_t>(std::max(shape.rows, 0)) * std::max(shape.cols, 0);
+    }
+
+    // Union-find over previous-row sets followed by the cells of the current row
+    std::uint32_t RowValidator::find(std::uint32_t x) {
+        while (parent_[x] != x) {
+            parent_[x] = parent_[parent_[x]];
+            x = parent_[x];
+        }
+        return x;
+    }
+
+    // False if a and b were already joined, i.e. the edge closes a cycle
+    bool RowValidator::unite(const std::uint32_t a, const std::uint32_t b) {
+        const std::uint32_t ra = find(a);
+        const std::uint32_t rb = find(b);
+        if (ra == rb) return false;
+        parent_[std::max(ra, rb)] = std::min(ra, rb);
+        return true;
+    }
+
+    // Border walls that must be open: the stored side of each endpoint's opening
+    bool RowValidator::right_opening(const int row) const {
+        const auto opens = [&](const std::pair<int, int>& cell) {
+            return cell.first == row && cell.second == shape_.cols - 1 && row != shape_.rows - 1 && row > 0;
+        };
+        return opens(shape_.entrance) || opens(shape_.exit) || std::ranges::any_of(shape_.extra_exits, opens);
+    }
+
+    bool RowValidator::bottom_opening(const int col) const {
+        const auto opens = [&](const std::pair<int, int>& cell) {
+            return cell.first == shape_.rows - 1 && cell.second == col;
+        };
+        return opens(shape_.entrance) || opens(shape_.exit) || std::ranges::any_of(shape_.extra_exits, opens);
+    }
+
+    void RowValidator::push_row(const bool* vWalls, const bool* hWalls) {
+        const auto start = std::chrono::steady_clock::now();
+        const int r = row_++;
+        const int cols = shape_.cols;
+        const std::uint64_t lastMask = cols % 64 ? (std::uint64_t{1} << (cols % 64)) - 1 : ~std::uint64_t{0};
+        const std::uint64_t borderBit = std::uint64_t{1} << ((cols - 1) & 63);
+
+        pack_open(vWalls, cols, right_);
+
+        // The last column's right wall is the border
+        if (right_[words_ - 1] & borderBit) {
+            if (!right_opening(r)) report_.border_gaps++;
+            right_[words_ - 1] &= ~borderBit;
+        } else if (right_opening(r)) {
+            report_.problems.push_back("Opening at " + cell_text({r, cols - 1}) + " is walled");
+        }
+        right_[words_ - 1] &= lastMask;
+
+        // Nodes: prevCount sets from the row above, then this row's cells
+        parent_.resize(prevCount_ + cols);
+        std::iota(parent_.begin(), parent_.end(), 0u);
+        if (r > 0) {
+            for_each_bit(down_, [&](const int c) {
+                report_.open_edges++;
+                if (!unite(prevLabel_[c], prevCount_ + c)) report_.cycles++;
+            });
+        }
+        for_each_bit(right_, [&](const int c) {
+            report_.open_edges++;
+            if (!unite(prevCount_ + c, prevCount_ + c + 1)) report_.cycles++;
+        });
+
+        // Sets of the row above that reached no cell of this row are finished
+        carried_.assign(prevCount_ + cols, 0);
+        for (int c = 0; c < cols; c++)
+            carried_[find(prevCount_ + c)] = 1;
+        for (std::uint32_t s = 0; s < prevCount_; s++)
+            if (!carried_[find(s)]) report_.components++;
+
+        // Relabel this row's sets 0..k-1 for the next row
+        compact_.assign(prevCount_ + cols, UINT32_MAX);
+        std::uint32_t count = 0;
+        for (int c = 0; c < cols; c++) {
+            const std::uint32_t root = find(prevCount_ + c);
+            if (compact_[root] == UINT32_MAX) compact_[root] = count++;
+            nextLabel_[c] = compact_[root];
+        }
+        prevLabel_.swap(nextLabel_);
+        prevCount_ = count;
+
+        pack_open(hWalls, cols, down_);
+        if (r == shape_.rows - 1) {
+            // Bottom border
+            for (int c = 0; c < cols; c++) {
+                const bool open = down_[c >> 6] >> (c & 63) & 1;
+                if (open && !bottom_opening(c)) report_.border_gaps++;
+                if (!open && bottom_opening(c))
+                    report_.problems.push_back("Opening at " + cell_text({r, c}) + " is walled");
+            }
+        }
+        report_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    ValidationReport RowValidator::finish() {
+        const auto start = std::chrono::steady_clock::now();
+        if (report_.cells == 0) {
+            report_.problems.emplace_back("Maze has no cells");
+            return report_;
+        }
+        if (row_ != shape_.rows)
+            report_.problems.push_back("Expected " + std::to_string(shape_.rows) + " rows, got " +
+                                       std::to_string(row_));
+        report_.components += prevCount_;
+
+        if (report_.components != 1)
+            report_.problems.push_back(std::to_string(report_.components) + " disconnected regions");
+        if (report_.cycles != 0)
+            report_.problems.push_back(std::to_string(report_.cycles) + " open edges close a cycle");
+        if (report_.border_gaps != 0)
+            report_.problems.push_back(std::to_string(report_.border_gaps) + " gaps in the outer wall");
+
+        std::vector<std::pair<std::string, std::pair<int, int>>> endpoints = {{"Entrance", shape_.entrance},
+                                                                              {"Exit", shape_.exit}};
+        for (size_t i = 0; i < shape_.extra_exits.size(); i++)
+            endpoints.emplace_back("Exit " + std::to_string(i + 2), shape_.extra_exits[i]);
+        for (const auto& [name, cell] : endpoints) {
+            const auto [row, col] = cell;
+            if (row < 0 || row >= shape_.rows || col < 0 || col >= shape_.cols)
+                report_.problems.push_back(std::string(name) + " " + cell_text(cell) + " is outside the maze");
+            else if (row != 0 && col != 0 && row != shape_.rows - 1 && col != shape_.cols - 1)
+                report_.problems.push_back(std::string(name) + " " + cell_text(cell) + " is not on the border");
+        }
+
+        report_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return report_;
+    }
+
+    ValidationReport validate_maze(const Maze& maze) {
+        RowValidator validator(maze.shape());
+        for (int r = 0; r < maze.getRows(); r++)
+            validator.push_row(maze.get_v_walls().row(r), maze.get_h_walls().row(r));
+        return validator.finish();
+    }
+
+    void ValidationReport::print(std::ostream& out) const {
+        out << (perfect() ? "VALID: perfect maze\n" : "INVALID: maze is not perfect\n");
+        out << "  Cells: " << cells << ", open edges: " << open_edges
+            << " (perfect: " << (cells ? cells - 1 : 0) << ")\n";
+        out << "  Regions: " << components << ", cycles: " << cycles
+            << ", border gaps: " << border_gaps << "\n";
+        for (const auto& problem : problems)
+            out << "  - " << problem << "\n";
+        out << "  Checked in " << seconds * 1e3 << " ms\n";
+    }
+}